@@ -0,0 +1,120 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <Ricoh2A03.hpp>
+#include <RicohRP2C02.hpp>
+#include <GamePak.hpp>
+#include <GamePad.hpp>
+#include <Apu2A03.hpp>
+#include <MachineState.hpp>
+#include <Hash64.hpp>
+
+/*
+ * Runs the same ROM through both interpreter cores and reports
+ * emulated instructions per second. The PPU is clocked alongside
+ * the CPU so that games make it past their vblank wait loops;
+ * OAM DMA is performed instantly since only the CPU is being timed.
+ */
+
+struct BenchResult
+{
+    uint64_t instructions;
+    double seconds;
+    uint16_t PC;
+    uint8_t A, X, Y, SP, S;
+    // Of the whole state block, so a core that corrupts RAM or the PPU shows up too
+    uint64_t stateHash;
+};
+
+template <Ricoh2A03::Core C>
+static BenchResult runCore(const std::string &romName, const uint32_t frames)
+{
+    std::unique_ptr<MachineState> machine{new MachineState{}};
+    std::shared_ptr<GamePad> p1{new GamePad{machine->pad}};
+    std::shared_ptr<RicohRP2C02> ppu{new RicohRP2C02{machine->ppu}};
+    std::shared_ptr<Ricoh2A03> cpu{new Ricoh2A03{machine->cpu, machine->ram, ppu, p1}};
+    std::shared_ptr<AddressableDevice> cart{new GamePak{romName, machine->cart, machine->cartRam}};
+
+    cpu->addCartridge(cart);
+    ppu->addCartridge(cart);
+    cpu->reset();
+    ppu->reset();
+
+    BenchResult result{};
+    auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t frame = 0; frame < frames; ++frame)
+    {
+        cpu->restartFrameTimer();
+        while (!cpu->isFrameDone())
+        {
+            ppu->run();
+            ppu->run();
+            ppu->run();
+
+            if (cpu->dma_transfer)
+            {
+                for (uint16_t i = 0; i < 0x100; ++i)
+                    ppu->pOAM[i] = cpu->read(cpu->dma_page << 8 | i);
+                cpu->dma_transfer = false;
+            }
+
+            if (cpu->cycles == 0)
+                ++result.instructions;
+            cpu->fetch<C>();
+            --cpu->remaining;
+
+            if (ppu->requestCpuNmi)
+            {
+                cpu->nmi();
+                ppu->requestCpuNmi = false;
+            }
+        }
+        cpu->processFrameAudio();
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.PC = cpu->PC;
+    result.A = cpu->A;
+    result.X = cpu->X;
+    result.Y = cpu->Y;
+    result.SP = cpu->SP;
+    result.S = cpu->S;
+    result.stateHash = hash64(machine.get(), stateBytes(*machine));
+
+    return result;
+}
+
+static void report(const char *name, const BenchResult &r)
+{
+    std::cout << name << ": " << r.instructions << " instructions in " << r.seconds << "s ("
+              << static_cast<uint64_t>(r.instructions / r.seconds) << " instr/s)" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: ./ness-bench <PATH_TO_ROM> [FRAMES]" << std::endl;
+        return 1;
+    }
+
+    const uint32_t frames = argc > 2 ? std::stoul(argv[2]) : 3600;
+
+    BenchResult vtable = runCore<Ricoh2A03::Core::VTABLE>(argv[1], frames);
+    BenchResult sw = runCore<Ricoh2A03::Core::SWITCH>(argv[1], frames);
+
+    report("vtable core", vtable);
+    report("switch core", sw);
+
+    bool identical = vtable.instructions == sw.instructions && vtable.PC == sw.PC &&
+                     vtable.A == sw.A && vtable.X == sw.X && vtable.Y == sw.Y &&
+                     vtable.SP == sw.SP && vtable.S == sw.S && vtable.stateHash == sw.stateHash;
+    std::cout << "speedup: " << vtable.seconds / sw.seconds << "x, final state "
+              << (identical ? "identical" : "DIVERGED") << std::endl;
+
+    return identical ? 0 : 1;
+}
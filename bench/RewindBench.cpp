@@ -0,0 +1,79 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <NesSystem.hpp>
+#include <RewindBuffer.hpp>
+
+/*
+ * Plays a ROM with pseudo-random input, recording every frame into a
+ * rewind buffer, and reports what capturing costs relative to emulating
+ * a frame, how much history fits, and how long restoring a frame takes.
+ */
+
+using Clock = std::chrono::steady_clock;
+
+static double micros(Clock::duration d)
+{
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: ./ness-rewind-bench <PATH_TO_ROM> [FRAMES] [CAPACITY_MB]" << std::endl;
+        return 1;
+    }
+
+    const uint32_t frames = argc > 2 ? std::stoul(argv[2]) : 3600;
+    const size_t capacity = (argc > 3 ? std::stoul(argv[3]) : REWIND_CAPACITY >> 20) << 20;
+
+    NesSystem nes(NesSystem::PLAY);
+    RewindBuffer rewind(capacity);
+    nes.insertCartridge(argv[1]);
+
+    Clock::duration emulating{}, capturing{};
+    uint32_t seed = 1;
+
+    for (uint32_t frame = 0; frame < frames; ++frame)
+    {
+        // A new random button combination every 8 frames
+        if ((frame & 0x7) == 0)
+        {
+            seed = seed * 1103515245 + 12345;
+            nes.setGameplayInput(seed >> 24);
+        }
+
+        const auto start = Clock::now();
+        nes.runFrame();
+        const auto emulated = Clock::now();
+        rewind.push(nes.captureState());
+        const auto captured = Clock::now();
+
+        emulating += emulated - start;
+        capturing += captured - emulated;
+    }
+
+    const double frameUs = micros(emulating) / frames;
+    const double captureUs = micros(capturing) / frames;
+
+    std::cout << "emulation: " << frameUs << "us/frame" << std::endl;
+    std::cout << "capture:   " << captureUs << "us/frame (" << 100.0 * captureUs / frameUs << "% overhead)" << std::endl;
+    std::cout << "history:   " << rewind.size() << " frames (" << rewind.size() / 60.0 << "s) in "
+              << rewind.bytesUsed() / 1024.0 << "KB of " << (capacity >> 20) << "MB, "
+              << rewind.bytesUsed() / static_cast<double>(rewind.size()) << " bytes/frame" << std::endl;
+
+    std::unique_ptr<MachineState> state{new MachineState{}};
+    const size_t held = rewind.size();
+    const auto start = Clock::now();
+
+    while (rewind.pop(*state))
+        nes.restoreState(*state);
+
+    std::cout << "restore:   " << micros(Clock::now() - start) / held << "us/frame" << std::endl;
+
+    return 0;
+}
@@ -67,6 +67,11 @@ public:
     void save_snapshot(apu_snapshot_t *out) const;
     void load_snapshot(apu_snapshot_t const &);
 
+    // Time of the frame counter's next IRQ, which snapshots leave out;
+    // restore it after load_snapshot() for an exact round trip
+    cpu_time_t next_frame_irq() const;
+    void set_next_frame_irq(cpu_time_t);
+
     // Set overall volume (default is 1.0)
     void volume(double);
 
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <RamExpression.hpp>
+#include <StateArena.hpp>
+#include <ThreadPool.hpp>
+
+class NesSystem;
+
+struct SearchConfig
+{
+    std::string romName;
+    // Maximised by the search, e.g. "$6D * 256 + $86"
+    std::string fitness;
+    // Movie to play before searching, kept at the start of the result
+    std::string prefixMovie;
+
+    uint32_t frames = 600;
+    // Every choice of buttons is held for this many frames
+    uint32_t hold = 4;
+    uint32_t beamWidth = 32;
+    // Zero means one per hardware thread
+    size_t threads = 0;
+
+    // Button combinations tried at every step; empty means a default set for running right
+    std::vector<uint8_t> actions;
+};
+
+/*
+ * Looks for the input that maximises a RAM expression by beam search:
+ * every step holds each action for a few frames from each state in the
+ * beam and keeps the best resulting states. Children are emulated in
+ * parallel, one cloned console per worker, and any state already seen
+ * (by hash, ignoring the clocks) is dropped as a transposition.
+ */
+class BeamSearch
+{
+    struct Node
+    {
+        MachineState *state;
+        int64_t fitness;
+        // Index into paths of the last step taken to reach this state
+        uint32_t path;
+    };
+
+    // Steps shared between the paths of all nodes, each pointing back to the one before
+    struct PathStep
+    {
+        uint32_t parent;
+        uint8_t action;
+    };
+
+    const SearchConfig config;
+    const RamExpression fitness;
+    std::vector<uint8_t> actions;
+
+    ThreadPool pool;
+    std::vector<std::unique_ptr<NesSystem>> consoles;
+    StateArena arena;
+
+    std::vector<Node> beam;
+    std::vector<Node> children;
+    std::vector<uint64_t> childHashes;
+    std::vector<PathStep> paths;
+    std::unordered_set<uint64_t> seen;
+
+    std::vector<uint8_t> startState;
+    std::vector<uint8_t> prefix;
+    uint32_t romCrc;
+
+    int64_t bestFitness;
+    uint32_t bestPath;
+    uint32_t depth;
+    size_t transpositions;
+
+    void expand(size_t task, size_t worker);
+    static uint64_t hashState(const MachineState &state);
+
+public:
+    // Throws std::invalid_argument for a bad fitness expression or prefix movie
+    explicit BeamSearch(const SearchConfig &config);
+    ~BeamSearch() noexcept;
+
+    // Advances every state in the beam by one held action; false once the frame budget is spent or the beam is empty
+    bool step();
+
+    uint32_t getFrame() const;
+    int64_t getBestFitness() const;
+    size_t getTranspositions() const;
+    // The prefix followed by the input leading to the best state found, one byte per frame
+    std::vector<uint8_t> getBestInput() const;
+    bool saveMovie(const std::string &path) const;
+
+    // Nothing, right with and without B (run) and A (jump), a standing jump and left
+    static const std::vector<uint8_t> &defaultActions();
+};
+
+// Plays a single-controller movie made on the console's ROM, keeping its start state (if any) and appending its input to prefix
+void playPrefixMovie(NesSystem &nes, const std::string &path, std::vector<uint8_t> &startState, std::vector<uint8_t> &prefix);
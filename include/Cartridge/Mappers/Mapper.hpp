@@ -3,16 +3,55 @@
 
 #include <HwConstants.hpp>
 
+// Bytes of board registers a mapper may keep in the machine's state block
+#define MAPPER_REGISTERS 16
+
+class GamePak;
+
+/*
+ * A cartridge board. Its registers live in the machine's state block and
+ * are turned into the cartridge's PRG and CHR bank pointers only when a
+ * write changes them, so reads never go through the mapper.
+ */
 class Mapper
 {
 protected:
+    GamePak &cart;
+    // In 16KB PRG and 8KB CHR units, as in the iNES header
     const uint8_t prgBanks;
     const uint8_t chrBanks;
+    uint8_t (&registers)[MAPPER_REGISTERS];
+
+    // Points size 8KB windows from window on at the bank-th run of size 8KB banks; negative banks count from the end
+    void mapPrg(uint8_t window, int32_t bank, uint8_t size);
+    // The same over the 1KB CHR windows
+    void mapChr(uint8_t window, int32_t bank, uint8_t size);
 
 public:
-    Mapper(const uint8_t prgBanks, const uint8_t chrBanks);
+    // What a register write changed
+    enum Update : uint8_t
+    {
+        NONE = 0x00,
+        PRG_BANKS = 0x01,
+        CHR_BANKS = 0x02,
+        // The IRQ counter or its settings
+        IRQ = 0x04,
+    };
+
+    explicit Mapper(GamePak &cart);
     virtual ~Mapper() = default;
 
-    virtual bool translatePrgAddress(uint16_t &addr) const = 0;
-    virtual bool translateChrAddress(uint16_t &addr) const = 0;
-};
\ No newline at end of file
+    // Power-on register values
+    virtual void reset();
+    // A CPU write to $8000-$FFFF, returning Update flags
+    virtual uint8_t writeRegister(uint16_t addr, uint8_t data) = 0;
+    // Points every window at the bank the registers select
+    virtual void updateBanks() = 0;
+
+    // Whether the board counts scanlines by watching PPU address line A12
+    virtual bool countsScanlines() const;
+    // One rising edge of A12, seen once per rendered line
+    virtual void clockScanline();
+    // Edges left before the IRQ is raised, or 0 if it is not armed
+    virtual uint32_t scanlinesUntilIrq() const;
+};
@@ -1,29 +1,13 @@
 #pragma once
 #include <Mapper.hpp>
 
-namespace M000
-{
-
-namespace PRG
-{
-const uint16_t Base = 0x8000;
-const uint16_t Limit = 0xFFFF;
-} // namespace PRG
-
-namespace CHR
-{
-const uint16_t Base = 0x0000;
-const uint16_t Limit = 0x1FFF;
-}; // namespace CHR
-
-}; // namespace M000
-
+// NROM: 16KB or 32KB of PRG and 8KB of CHR, no registers
 class Mapper000 : public Mapper
 {
 public:
-    Mapper000(const uint8_t prgBanks, const uint8_t chrBanks);
+    explicit Mapper000(GamePak &cart);
     virtual ~Mapper000() = default;
 
-    bool translatePrgAddress(uint16_t &addr) const override;
-    bool translateChrAddress(uint16_t &addr) const override;
-};
\ No newline at end of file
+    uint8_t writeRegister(uint16_t addr, uint8_t data) override;
+    void updateBanks() override;
+};
@@ -0,0 +1,24 @@
+#pragma once
+#include <Mapper.hpp>
+
+/*
+ * MMC1 (SxROM): registers are loaded a bit at a time through a 5-bit
+ * shift register, and select 16KB or 32KB PRG banks and 4KB or 8KB CHR
+ * banks. 512KB boards use a CHR register bit to pick a 256KB PRG half.
+ */
+class Mapper001 : public Mapper
+{
+    uint8_t &shift = registers[0];
+    uint8_t &control = registers[1];
+    uint8_t &chrBank0 = registers[2];
+    uint8_t &chrBank1 = registers[3];
+    uint8_t &prgBank = registers[4];
+
+public:
+    explicit Mapper001(GamePak &cart);
+    virtual ~Mapper001() = default;
+
+    void reset() override;
+    uint8_t writeRegister(uint16_t addr, uint8_t data) override;
+    void updateBanks() override;
+};
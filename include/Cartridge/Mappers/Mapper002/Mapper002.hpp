@@ -0,0 +1,15 @@
+#pragma once
+#include <Mapper.hpp>
+
+// UxROM: a switchable 16KB PRG bank at $8000, the last one fixed at $C000
+class Mapper002 : public Mapper
+{
+    uint8_t &prgBank = registers[0];
+
+public:
+    explicit Mapper002(GamePak &cart);
+    virtual ~Mapper002() = default;
+
+    uint8_t writeRegister(uint16_t addr, uint8_t data) override;
+    void updateBanks() override;
+};
@@ -0,0 +1,15 @@
+#pragma once
+#include <Mapper.hpp>
+
+// CNROM: fixed PRG as on NROM and a switchable 8KB CHR bank
+class Mapper003 : public Mapper
+{
+    uint8_t &chrBank = registers[0];
+
+public:
+    explicit Mapper003(GamePak &cart);
+    virtual ~Mapper003() = default;
+
+    uint8_t writeRegister(uint16_t addr, uint8_t data) override;
+    void updateBanks() override;
+};
@@ -0,0 +1,30 @@
+#pragma once
+#include <Mapper.hpp>
+
+/*
+ * MMC3 (TxROM): two switchable 8KB PRG banks with the second to last bank
+ * fixed at either $8000 or $C000, and two 2KB plus four 1KB CHR banks
+ * whose halves of the pattern tables can be swapped. A scanline counter
+ * clocked by A12 rising edges raises an IRQ when it reaches zero.
+ */
+class Mapper004 : public Mapper
+{
+    uint8_t &bankSelect = registers[0];
+    // R0-R7, as written through $8001
+    uint8_t *const banks = &registers[1];
+    uint8_t &irqLatch = registers[9];
+    uint8_t &irqCounter = registers[10];
+    uint8_t &irqReload = registers[11];
+    uint8_t &irqEnabled = registers[12];
+
+public:
+    explicit Mapper004(GamePak &cart);
+    virtual ~Mapper004() = default;
+
+    uint8_t writeRegister(uint16_t addr, uint8_t data) override;
+    void updateBanks() override;
+
+    bool countsScanlines() const override;
+    void clockScanline() override;
+    uint32_t scanlinesUntilIrq() const override;
+};
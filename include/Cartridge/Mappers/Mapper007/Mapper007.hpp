@@ -0,0 +1,16 @@
+#pragma once
+#include <Mapper.hpp>
+
+// AxROM: a switchable 32KB PRG bank and a register bit picking the single nametable
+class Mapper007 : public Mapper
+{
+    uint8_t &bankSelect = registers[0];
+
+public:
+    explicit Mapper007(GamePak &cart);
+    virtual ~Mapper007() = default;
+
+    void reset() override;
+    uint8_t writeRegister(uint16_t addr, uint8_t data) override;
+    void updateBanks() override;
+};
@@ -0,0 +1,6 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// CRC-32 (IEEE 802.3, as used by zip and ROM databases); pass the previous result to continue a running CRC
+uint32_t crc32(const uint8_t *data, size_t size, uint32_t crc = 0);
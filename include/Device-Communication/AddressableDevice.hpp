@@ -15,4 +15,7 @@ public:
 
     uint8_t read(uint16_t addr, uint16_t mirror, bool readOnly = false);
     void write(uint16_t addr, uint16_t mirror, uint8_t data);
+
+    // Host memory backing the 256 byte page starting at addr, or nullptr if it must go through read/write
+    virtual uint8_t *getPage(uint16_t addr, uint16_t mirror, bool write);
 };
\ No newline at end of file
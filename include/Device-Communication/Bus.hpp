@@ -2,7 +2,8 @@
 #include <cstdint>
 #include <memory>
 
-class MMU;
+#include <MMU.hpp>
+
 class AddressableDevice;
 class GamePad;
 
@@ -18,4 +19,16 @@ public:
     uint8_t read(uint16_t addr, bool readOnly = false);
     void attachDevice(const uint16_t base, const uint16_t limit,
                       const uint16_t mirror, std::shared_ptr<AddressableDevice> device) const;
+    // Rebuilds the pages from first to last
+    void remap(uint16_t first = 0x0000, uint16_t last = 0xFFFF) const;
+
+    inline uint8_t *readPage(uint16_t addr) const
+    {
+        return mmu->readPage(addr);
+    }
+
+    inline uint8_t *writePage(uint16_t addr) const
+    {
+        return mmu->writePage(addr);
+    }
 };
\ No newline at end of file
@@ -1,16 +1,23 @@
 #pragma once
 #include <cstdint>
-#include <SDL2/SDL.h>
 
-class GamePad
+// Held buttons and the serial shift register, kept in the machine's state block
+struct PadState
 {
     uint8_t buttonReg;
     uint8_t buttonState;
+};
+
+class GamePad
+{
+    PadState &state;
+    uint8_t &buttonReg = state.buttonReg;
+    uint8_t &buttonState = state.buttonState;
 
 public:
-    GamePad();
+    explicit GamePad(PadState &state);
     ~GamePad() = default;
-    void registerInputStateChange(const SDL_Event &e);
+    void registerInputStateChange(const uint8_t btn, const bool pressed);
     void writeButtonState();
     uint8_t readStateMSB();
     uint8_t readPressReg() const;
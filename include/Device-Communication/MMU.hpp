@@ -1,6 +1,7 @@
 #pragma once
 #include <cstdint>
 #include <vector>
+#include <array>
 #include <memory>
 
 class AddressableDevice;
@@ -13,17 +14,43 @@ typedef struct
     std::shared_ptr<AddressableDevice> device;
 } AddressingInfo;
 
+/*
+ * One entry per 256 byte page of the address space.
+ * Pages backed by plain memory (RAM, PRG ROM) get direct host
+ * pointers so an access is a single indexed load. Register pages
+ * keep a handler to the owning device, and pages shared between
+ * devices fall back to scanning virtToPhys.
+ */
+typedef struct
+{
+    uint8_t *read;
+    uint8_t *write;
+    const AddressingInfo *handler;
+} PageEntry;
+
 class MMU
 {
     std::vector<AddressingInfo> virtToPhys;
+    std::array<PageEntry, 0x100> pages;
     // uint8_t controller_state[2];
     // uint8_t controller[2];
 
 public:
-    MMU() = default;
+    MMU();
     ~MMU() = default;
 
     void addEntry(const AddressingInfo entry);
+    void remap(uint16_t first = 0x0000, uint16_t last = 0xFFFF);
     uint8_t read(uint16_t addr);
     void write(uint16_t addr, uint8_t data);
-};
\ No newline at end of file
+
+    inline uint8_t *readPage(uint16_t addr) const
+    {
+        return pages[addr >> 8].read;
+    }
+
+    inline uint8_t *writePage(uint16_t addr) const
+    {
+        return pages[addr >> 8].write;
+    }
+};
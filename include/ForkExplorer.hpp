@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <HwConstants.hpp>
+
+// Children alive at once; each holds a pipe slot and a few dirtied pages
+#define FORK_MAX_CHILDREN 1024
+
+class NesSystem;
+class RamExpression;
+
+struct BranchResult
+{
+    // False if the child died before reporting
+    bool completed;
+    int64_t fitness;
+    uint8_t ram[CPU::RAM::Size];
+};
+
+/*
+ * Explores input suffixes from a branch point by forking the whole
+ * process once per suffix. Children share the console, ROM and every
+ * other page with the parent copy-on-write, so a clone costs a page
+ * table copy and only the few pages a frame dirties are ever duplicated.
+ * Each child plays its suffix with nothing drawn or heard, writes the
+ * RAM and fitness it reached into one shared pipe and exits.
+ */
+class ForkExplorer
+{
+    NesSystem &nes;
+    const RamExpression &fitness;
+    const size_t maxChildren;
+
+    [[noreturn]] void runChild(uint32_t branch, const std::vector<uint8_t> &suffix, int out);
+
+public:
+    ForkExplorer(NesSystem &nes, const RamExpression &fitness, size_t maxChildren = FORK_MAX_CHILDREN);
+
+    // Runs every suffix from the console's current state, one byte of input per frame; throws std::runtime_error if no child can be started
+    std::vector<BranchResult> explore(const std::vector<std::vector<uint8_t>> &suffixes);
+};
@@ -16,12 +16,9 @@
 #define RADIUS 10
 
 class FileExplorer;
-class GamePad;
 
 class Display
 {
-    std::shared_ptr<GamePad> p1Controller;
-
     inline void drawButtonPress(const uint8_t buttonI);
     inline void drawCartridgeSlot();
 
@@ -47,9 +44,9 @@ public:
 
     std::array<std::pair<uint16_t, uint16_t>, 0x8> buttonCoords;
 
-    Display(const uint16_t width, const uint16_t height, const uint32_t *fb, std::shared_ptr<GamePad> p1);
+    Display(const uint16_t width, const uint16_t height, const uint32_t *fb);
     ~Display() noexcept;
 
-    void blit();
+    void blit(const uint8_t activePress);
     void setActiveButtons(const uint8_t activePress);
 };
\ No newline at end of file
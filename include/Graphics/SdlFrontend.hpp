@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+
+#include <Display.hpp>
+#include <Sound_Queue.h>
+#include <Sinks.hpp>
+#include <SDL2/SDL.h>
+
+class NesSystem;
+
+/*
+ * Windowed front end: presents frames, plays audio, polls the keyboard
+ * and paces a NesSystem to 60 frames per second.
+ */
+class SdlFrontend : public VideoSink, public AudioSink
+{
+    NesSystem &nes;
+
+    std::unique_ptr<Display> screen;
+    std::unique_ptr<Sound_Queue> soundQueue;
+
+    const uint32_t fps, delay;
+    double delayMultiplier;
+
+    uint32_t frameStart, frameTime;
+    SDL_Event e;
+    bool rewindHeld;
+
+    void processGameplayInput(const SDL_Event &event);
+
+public:
+    SdlFrontend(NesSystem &nes);
+    ~SdlFrontend() noexcept;
+
+    void pushFrame(const uint32_t *frameBuffer) override;
+    void pushSamples(const blip_sample_t *samples, size_t count) override;
+    bool run();
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <MachineState.hpp>
+
+/*
+ * The state before every frame of the movie being recorded, so editing
+ * can jump to any frame without replaying from the start. States are
+ * keyframes every keyframeInterval frames and deltas against the
+ * keyframe before them. Past the memory budget the oldest deltas are
+ * dropped first, then every other keyframe from the oldest on, so old
+ * frames cost a short replay from the nearest keyframe and recent
+ * ones none.
+ */
+class Greenzone
+{
+    struct Entry
+    {
+        std::vector<uint8_t> data;
+        bool keyframe;
+    };
+
+    std::vector<Entry> frames;
+    size_t budget;
+    size_t bytes;
+    const uint32_t keyframeInterval;
+    // Deltas before this frame have all been thinned out
+    uint32_t oldestDelta;
+
+    // Decoded copy of the newest keyframe, which new deltas are taken against
+    std::unique_ptr<MachineState> base;
+    uint32_t baseFrame;
+    bool baseValid;
+
+    std::vector<uint8_t> scratch;
+
+    void drop(uint32_t frame);
+    void thin();
+    uint32_t keyframeBefore(uint32_t frame) const;
+
+public:
+    Greenzone(size_t budget, uint32_t keyframeInterval = 30);
+
+    // Stores the state before the given frame, at most one past the last one stored
+    void store(uint32_t frame, const MachineState &state);
+    // Loads the newest state at or before frame into state and returns its frame; frame 0 must be stored
+    uint32_t restore(uint32_t frame, MachineState &state);
+    // Forgets every state after frame, because the input from there on has changed
+    void truncate(uint32_t frame);
+
+    // Number of frames covered, including ones thinned out
+    uint32_t size() const;
+    bool has(uint32_t frame) const;
+    size_t bytesUsed() const;
+};
@@ -0,0 +1,6 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Fast non-cryptographic 64-bit hash of a byte range, a word at a time; pass a previous result as seed to chain ranges
+uint64_t hash64(const void *data, size_t size, uint64_t seed = 0);
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class NesSystem;
+
+/*
+ * One 64-bit hash per subsystem per frame, for checking that a movie
+ * plays back the same way across builds. A log file is this header
+ * followed by the hashes, frame by frame, in host byte order.
+ */
+#define HASHLOG_MAGIC 0x4C48534E // 'NSHL'
+#define HASHLOG_VERSION 1
+
+struct HashLogHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t subsystems;
+    uint32_t romCrc;
+    uint32_t frameCount;
+};
+
+struct FrameHashes
+{
+    // In the order a divergence usually spreads, so the first mismatch points at the cause
+    enum Subsystem
+    {
+        CPU, // registers, timing and controller latches
+        RAM,
+        CART,
+        PPU,
+        APU,
+        FRAMEBUFFER,
+        Count
+    };
+
+    uint64_t hash[Count];
+
+    static const char *name(Subsystem subsystem);
+};
+
+class HashLog
+{
+    HashLogHeader header;
+    std::vector<FrameHashes> frames;
+
+public:
+    static const size_t NoDivergence = SIZE_MAX;
+
+    explicit HashLog(uint32_t romCrc = 0);
+
+    static FrameHashes hashFrame(NesSystem &nes);
+    void push(const FrameHashes &hashes);
+    size_t size() const;
+    const FrameHashes &operator[](size_t frame) const;
+
+    bool save(const std::string &path);
+    // Throws std::invalid_argument if the file is not a hash log
+    void load(const std::string &path);
+
+    uint32_t getRomCrc() const;
+    // Index of the first frame where the logs differ, including one ending early, or NoDivergence
+    size_t firstDivergence(const HashLog &reference) const;
+};
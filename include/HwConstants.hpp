@@ -69,6 +69,12 @@ namespace CARTRIDGE
 {
 constexpr uint16_t PrgBankSize = 0x4000;
 constexpr uint16_t ChrBankSize = 0x2000;
+// Mappers switch banks in windows of these sizes or multiples of them
+constexpr uint16_t PrgWindowSize = 0x2000;
+constexpr uint16_t ChrWindowSize = 0x0400;
+constexpr uint16_t PrgRamBase = 0x6000;
+constexpr uint16_t PrgRamSize = 0x2000;
+constexpr uint16_t PrgRomBase = 0x8000;
 }; // namespace CARTRIDGE
 
 /*********** Graphical Constants ***********/
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <Scheduler.hpp>
+#include <HwConstants.hpp>
+#include <Ricoh2A03.hpp>
+#include <RicohRP2C02.hpp>
+#include <GamePak.hpp>
+#include <GamePad.hpp>
+#include <apu_snapshot.h>
+
+// NesSystem's own timing and DMA latches
+struct SystemState
+{
+    uint64_t systemClock;
+    uint64_t lastCpuTick;
+    uint64_t frameCount;
+    Scheduler scheduler;
+    uint8_t dma_data;
+    bool dma_dummy;
+    bool irqLine;
+};
+
+/*
+ * All mutable emulated state of one console. Components hold references
+ * into it rather than owning their fields, and nothing in it points
+ * anywhere, so a console is cloned by copying this block and rebuilding
+ * the few caches kept outside it. ROM images and the frame buffer are
+ * not state and stay with their owners.
+ * Nes_Apu links its oscillators to each other and to its Blip_Buffer,
+ * so it runs outside the block and is captured into apu on the way out,
+ * along with the frame IRQ time its snapshot has no room for.
+ * The cartridge's RAM comes last and only as much of it as the board
+ * has is live, so most games copy, hash and store well under 8KB.
+ */
+struct alignas(64) MachineState
+{
+    SystemState system;
+    CpuState cpu;
+    PadState pad;
+    uint8_t ram[CPU::RAM::Size];
+    PpuState ppu;
+    CartState cart;
+    apu_snapshot_t apu;
+    int64_t apuFrameIrq;
+    // PRG RAM then CHR RAM, each only if the board has it; cart.ramSize bytes are used
+    uint8_t cartRam[CARTRIDGE::PrgRamSize + CARTRIDGE::ChrBankSize];
+};
+
+static_assert(std::is_trivially_copyable<MachineState>::value, "MachineState is copied with memcpy");
+static_assert(std::is_standard_layout<MachineState>::value, "MachineState must stay plain data");
+static_assert(offsetof(MachineState, cartRam) % sizeof(uint64_t) == 0, "the live part of MachineState is whole words");
+
+// How much of a state block is live: everything up to the cartridge RAM and the RAM the board has
+inline size_t stateBytes(const MachineState &state)
+{
+    return offsetof(MachineState, cartRam) + state.cart.ramSize;
+}
@@ -3,15 +3,29 @@
 #include <memory>
 #include <string>
 #include <vector>
-#include <Display.hpp>
 #include <Ricoh2A03.hpp>
 #include <Apu2A03.hpp>
-#include <Sound_Queue.h>
-#include <SDL2/SDL.h>
+#include <Scheduler.hpp>
+#include <Sinks.hpp>
+#include <SaveState.hpp>
+#include <MachineState.hpp>
+
+// Enough for a minute of per-frame rewind in typical games
+#define REWIND_CAPACITY (16 << 20)
+// Every frame of a movie of an hour or so, before older frames are thinned
+#define GREENZONE_BUDGET (256 << 20)
+// One pass of an idle loop, a 3-cycle JMP to itself
+#define IDLE_LOOP_DOTS 9
 
 class RicohRP2C02;
 class NesSystem;
 class GamePad;
+class GamePak;
+class StateArena;
+class RewindBuffer;
+class RunAheadWorker;
+class TasReader;
+class Greenzone;
 
 class NesSystem
 {
@@ -24,42 +38,114 @@ public:
     };
 
 private:
-    uint32_t systemClock;
+    // What a frame run by emulateFrame() sends out
+    enum FrameOutput : uint8_t
+    {
+        VIDEO = 0x1,
+        AUDIO = 0x2,
+        RECORD = 0x4, // into the rewind buffer
+    };
+
+    std::unique_ptr<StateArena> ownArena;
+    StateArena *arena;
+    MachineState *machine;
+
+    uint64_t &systemClock = machine->system.systemClock;
+    uint64_t &lastCpuTick = machine->system.lastCpuTick;
+    bool &irqLine = machine->system.irqLine;
+    Scheduler &scheduler = machine->system.scheduler;
     std::shared_ptr<GamePad> p1Controller;
 
     std::shared_ptr<RicohRP2C02> ppu;
     std::shared_ptr<Ricoh2A03> cpu;
     std::shared_ptr<Apu2A03> apu;
+    GamePak *cart;
+    // From the ROM database; zero when the game's idle loop is unknown
+    uint16_t idleLoop;
 
-    std::unique_ptr<Display> screen;
-    std::unique_ptr<Sound_Queue> soundQueue;
+    VideoSink *videoSink;
+    IndexedVideoSink *indexedSink;
+    bool indexedOutput;
 
-    uint8_t dma_data;
-    bool dma_dummy;
+    uint8_t &dma_data = machine->system.dma_data;
+    bool &dma_dummy = machine->system.dma_dummy;
 
-    const uint32_t fps, delay;
-    double delayMultiplier;
     const EmuState state;
 
-    uint32_t frameStart, frameTime, commandI;
-    SDL_Event e;
+    uint64_t &frameCount = machine->system.frameCount;
     const std::string scriptPath;
+    std::string romName;
+
+    std::unique_ptr<TasReader> movieReader;
+    // Input recorded so far, one byte per frame
+    std::vector<uint8_t> movieInput;
+    std::unique_ptr<Greenzone> greenzone;
+
+    std::unique_ptr<RewindBuffer> rewindBuffer;
+    uint32_t rewindInterval;
 
-    std::vector<uint8_t> commands;
-    void parseTasScript();
+    uint32_t runAheadFrames;
+    std::unique_ptr<MachineState> runAheadState;
+    std::unique_ptr<RunAheadWorker> runAheadWorker;
+    bool runAheadSynced;
+    uint8_t runAheadInput;
+
+    void step();
+    uint64_t skipIdleLoop(uint64_t tick);
+    void syncEvents();
+    void scheduleApuIrq();
+    static void apuIrqChanged(void *nes);
+    void scheduleMapperIrq();
+    static void mapperIrqChanged(void *nes);
+    void stateLoaded();
+    void emulateFrame(uint8_t output);
+    void runAhead();
+    void runAheadThreaded();
 
 public:
-    NesSystem(EmuState state, std::string outputPath = "");
+    NesSystem(EmuState state, std::string outputPath = "", StateArena *arena = nullptr);
     ~NesSystem() noexcept;
 
     void tick();
     void reset();
     void insertCartridge(const std::string &romName);
     uint64_t getFrameCount() const;
-    void newSamples(const blip_sample_t *samples, size_t count);
-    void processGameplayInput(const SDL_Event &event);
+    EmuState getState() const;
+    uint32_t getRomCrc() const;
+    const uint32_t *getFrameBuffer() const;
+    void setVideoSink(VideoSink *sink);
+    // The PPU writes either ARGB colours or palette indices, and only the matching sink is fed
+    void setIndexedOutput(bool enabled);
+    bool getIndexedOutput() const;
+    void setIndexedVideoSink(IndexedVideoSink *sink);
+    const uint8_t *getIndexBuffer() const;
+    const uint32_t *getPalette() const;
+    void setAudioSink(AudioSink *sink);
+    void processGameplayInput(const uint8_t btn, const bool pressed);
     void setGameplayInput(const uint8_t btns);
-    void outputFrame() const;
-    bool run();
+    uint8_t getGameplayInput() const;
+    bool loadGameplayInput();
     void saveGameplayInput();
+    void outputFrame() const;
+    void runFrame();
+    // Emulates a frame with nothing drawn, heard or recorded
+    void skipFrame();
+
+    size_t stateSize() const;
+    void saveState(std::vector<uint8_t> &out);
+    bool loadState(const std::vector<uint8_t> &state);
+    void copyStateFrom(NesSystem &other);
+    const MachineState &captureState();
+    void restoreState(const MachineState &state);
+
+    void enableRewind(size_t capacity, uint32_t interval = 1);
+    bool rewindFrame();
+    const RewindBuffer *getRewindBuffer() const;
+
+    void enableRunAhead(uint32_t frames, bool secondInstance = false);
+
+    void enableGreenzone(size_t budget);
+    uint32_t getMovieLength() const;
+    bool seekMovie(uint32_t frame);
+    const Greenzone *getGreenzone() const;
 };
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Sinks.hpp>
+
+// The usual input size of Atari-style agents
+#define OBSERVATION_SIZE 84
+
+/*
+ * Shrinks palette-index frames to small grayscale observations. Every
+ * output pixel is the mean luma of the box of source pixels it covers,
+ * computed in one pass over the indices. With max pooling, the result
+ * is the brighter of the last two frames at each pixel, so sprites the
+ * game flickers on alternate frames are still seen.
+ */
+class ObservationFilter : public IndexedVideoSink
+{
+    const uint16_t width;
+    const uint16_t height;
+    const bool maxPool;
+
+    uint8_t luma[0x40];
+    // Source column and row each output box starts at, with one past the last box at the end
+    std::vector<uint16_t> columns;
+    std::vector<uint16_t> rows;
+    std::vector<uint32_t> sums;
+
+    std::vector<uint8_t> frames[2];
+    uint8_t latest;
+    std::vector<uint8_t> pooled;
+
+public:
+    // Throws std::invalid_argument unless the size is between 1x1 and the full 256x240
+    ObservationFilter(const uint32_t *palette, uint16_t width = OBSERVATION_SIZE, uint16_t height = OBSERVATION_SIZE,
+                      bool maxPool = true);
+
+    void pushFrame(const uint8_t *indices) override;
+    // Forgets the previous frame, e.g. at the start of an episode
+    void reset();
+
+    // width x height bytes of luma, one row after another
+    const uint8_t *getFrame() const;
+    size_t size() const;
+};
@@ -7,6 +7,8 @@ class PaletteRam : public Ram
     uint16_t mirrorAddress(uint16_t addr, uint16_t mirror);
 
 public:
-    explicit PaletteRam(const uint16_t size);
+    explicit PaletteRam(uint8_t *contents);
     ~PaletteRam() = default;
+
+    uint8_t *getPage(uint16_t addr, uint16_t mirror, bool write) override;
 };
\ No newline at end of file
@@ -8,6 +8,6 @@ class VRam : public Ram
     uint16_t mirrorAddress(uint16_t addr, uint16_t mirror) override;
 
 public:
-    VRam(const uint16_t size, GamePak::MirrorMode mMode);
+    VRam(uint8_t *contents, GamePak::MirrorMode mMode);
     ~VRam() = default;
 };
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define RAMEXPR_MAX_DEPTH 32
+
+/*
+ * An integer expression over CPU RAM, such as "$6D * 256 + $86" for a
+ * player's X position in pages and pixels. $hex reads the byte at that
+ * address (mirrored into the 2KB of RAM); numbers are decimal or 0x hex.
+ * Supports + - * / % & | ^ << >>, comparisons giving 0 or 1, unary minus
+ * and parentheses, with C precedence. Parsed once into postfix so
+ * evaluating it is a tight loop.
+ */
+class RamExpression
+{
+    enum Op : uint8_t
+    {
+        CONSTANT,
+        LOAD,
+        NEGATE,
+        ADD,
+        SUBTRACT,
+        MULTIPLY,
+        DIVIDE,
+        MODULO,
+        AND,
+        OR,
+        XOR,
+        EQUAL,
+        NOT_EQUAL,
+        LESS,
+        LESS_EQUAL,
+        GREATER,
+        GREATER_EQUAL,
+        SHIFT_LEFT,
+        SHIFT_RIGHT,
+    };
+
+    struct Instruction
+    {
+        Op op;
+        int64_t value;
+    };
+
+    std::vector<Instruction> program;
+    size_t depth;
+
+    const std::string source;
+    size_t pos;
+
+    void skipSpaces();
+    bool accept(const char *token);
+    void binary(int level);
+    void unary();
+    void emit(Op op, int64_t value = 0);
+
+public:
+    // Throws std::invalid_argument with the offending position on a syntax error
+    explicit RamExpression(const std::string &source);
+
+    int64_t evaluate(const uint8_t *ram) const;
+};
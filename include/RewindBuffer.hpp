@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <MachineState.hpp>
+
+/*
+ * Recent machine states in a fixed-size byte ring, newest last.
+ * Every keyframeInterval-th state is a keyframe; the ones in between
+ * are stored as deltas against it (see StateDelta.hpp). Once the ring
+ * is full the oldest keyframe is dropped together with the deltas that
+ * need it.
+ */
+class RewindBuffer
+{
+    struct Entry
+    {
+        size_t offset;
+        size_t size;
+        uint64_t sequence;
+        bool keyframe;
+    };
+
+    std::vector<uint8_t> ring;
+    std::deque<Entry> entries;
+    size_t head;
+    uint64_t nextSequence;
+
+    const uint32_t keyframeInterval;
+    uint32_t sinceKeyframe;
+
+    // Decoded keyframe that deltas are taken against, and its sequence number
+    std::unique_ptr<MachineState> base;
+    uint64_t baseSequence;
+    bool baseValid;
+
+    // The encoded state being pushed
+    std::vector<uint8_t> scratch;
+    bool pendingKeyframe;
+
+    void encode(const MachineState &state, bool keyframe);
+    void store(const MachineState &state);
+
+public:
+    RewindBuffer(size_t capacity, uint32_t keyframeInterval = 60);
+    ~RewindBuffer() = default;
+
+    void push(const MachineState &state);
+    // Moves the newest state into state and forgets it, false once empty
+    bool pop(MachineState &state);
+    void clear();
+
+    size_t size() const;
+    size_t bytesUsed() const;
+    size_t capacity() const;
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class NesSystem;
+
+/*
+ * A second console on its own thread that plays ahead of the one being
+ * shown. It is handed frames to emulate and keeps its state between
+ * jobs, so while the input holds steady it only needs one frame per
+ * frame of the real console to stay ahead.
+ */
+class RunAheadWorker
+{
+    std::unique_ptr<NesSystem> nes;
+
+    std::thread thread;
+    std::mutex lock;
+    std::condition_variable wake;
+
+    uint32_t pendingFrames;
+    uint8_t pendingInput;
+    bool quit;
+
+    void work();
+
+public:
+    RunAheadWorker(const std::string &romName);
+    ~RunAheadWorker() noexcept;
+
+    // Copies the state of the real console; only call while no frames are pending
+    void resync(NesSystem &source);
+    void start(uint8_t input, uint32_t frames);
+    // Waits for the pending frames and returns the last one
+    const uint32_t *finish();
+};
@@ -0,0 +1,19 @@
+#pragma once
+#include <cstdint>
+
+/*
+ * A save state is this header followed by a raw copy of MachineState,
+ * in host byte order. Bump the version whenever MachineState changes.
+ * States only load into a console running the ROM they were taken on.
+ */
+#define SAVESTATE_MAGIC 0x5353454E // 'NESS'
+#define SAVESTATE_VERSION 7
+
+struct SaveStateHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;
+    // CRC-32 of the PRG and CHR ROM, as in GamePak::romCrc
+    uint32_t romCrc;
+};
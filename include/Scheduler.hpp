@@ -0,0 +1,77 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <limits>
+
+/*
+ * Timestamped events on the master (PPU dot) clock.
+ * There is only ever one pending instance of each event type,
+ * so the queue is a fixed slot per type with the earliest cached.
+ */
+class Scheduler
+{
+public:
+    enum Event
+    {
+        VBLANK,
+        FRAME_END,
+        APU_IRQ,
+        MAPPER_IRQ,
+        OAM_DMA,
+        EVENT_COUNT,
+    };
+
+    static constexpr uint64_t Never = std::numeric_limits<uint64_t>::max();
+
+private:
+    std::array<uint64_t, EVENT_COUNT> times;
+    Event earliest;
+
+    inline void updateEarliest()
+    {
+        earliest = VBLANK;
+        for (uint8_t e = 1; e < EVENT_COUNT; ++e)
+        {
+            if (times[e] < times[earliest])
+                earliest = static_cast<Event>(e);
+        }
+    }
+
+public:
+    Scheduler() : earliest{VBLANK}
+    {
+        clear();
+    }
+
+    inline void clear()
+    {
+        times.fill(Never);
+        earliest = VBLANK;
+    }
+
+    inline void schedule(Event e, uint64_t time)
+    {
+        times[e] = time;
+        updateEarliest();
+    }
+
+    inline void cancel(Event e)
+    {
+        schedule(e, Never);
+    }
+
+    inline uint64_t time(Event e) const
+    {
+        return times[e];
+    }
+
+    inline Event next() const
+    {
+        return earliest;
+    }
+
+    inline uint64_t nextTime() const
+    {
+        return times[earliest];
+    }
+};
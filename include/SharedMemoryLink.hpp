@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <HwConstants.hpp>
+
+#define SHM_MAGIC 0x4D48534E // 'NSHM'
+#define SHM_VERSION 1
+// Polls of an idle control block before backing off to short sleeps
+#define SHM_SPIN_LIMIT 4096
+
+class NesSystem;
+
+// Written by the emulator. Read sequence, copy what is needed, and read it again: an odd or changed value means a torn copy
+struct alignas(64) ShmStatus
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t romCrc;
+    std::atomic<uint32_t> sequence;
+    // The control request this observation answers
+    uint32_t served;
+    // Non-zero when frame holds palette-index bytes instead of ARGB colours
+    uint8_t indexed;
+    uint8_t reserved[3];
+    uint64_t frameCount;
+};
+
+// Written by the agent: set command and input, then bump request
+struct alignas(64) ShmControl
+{
+    std::atomic<uint32_t> request;
+    uint8_t command;
+    // Buttons for controller 1, as in a TAS movie
+    uint8_t input;
+};
+
+/*
+ * The segment as mapped by both sides, at fixed offsets so agents in any
+ * language can use it: status at 0, control at 64, the 2KB of CPU RAM at
+ * 128 and the 256x240 frame at 2176.
+ */
+struct ShmSegment
+{
+    ShmStatus status;
+    ShmControl control;
+    uint8_t ram[CPU::RAM::Size];
+    uint32_t frame[DISPLAY::Width * DISPLAY::Height];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "The sequence counters are shared between processes");
+static_assert(offsetof(ShmSegment, ram) == 128 && offsetof(ShmSegment, frame) == 2176, "The segment layout is an interface");
+
+/*
+ * Lets an agent in another process drive a console through a POSIX
+ * shared-memory segment, with no sockets or serialization. Observations
+ * are published under a sequence lock, so the agent can read them in
+ * place; requests are a counter the emulator polls.
+ */
+class SharedMemoryLink
+{
+public:
+    enum Command : uint8_t
+    {
+        STEP,  // Hold input for the next frames
+        RESET, // Go back to the start state
+        QUIT,
+    };
+
+private:
+    const std::string name;
+    ShmSegment *segment;
+    uint32_t served;
+
+public:
+    // Creates (or takes over) the segment /name; throws std::invalid_argument if it cannot
+    SharedMemoryLink(const std::string &name, uint32_t romCrc);
+    ~SharedMemoryLink() noexcept;
+
+    // frame stands in for the console's picture when that does not go with its state, e.g. right after a restore
+    void publish(NesSystem &nes, const void *frame = nullptr);
+    // Blocks until the agent bumps the request counter
+    Command waitForRequest();
+    uint8_t getInput() const;
+};
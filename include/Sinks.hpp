@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include <Blip_Buffer.h>
+
+/*
+ * Optional outputs of a NesSystem. A headless instance simply
+ * leaves them unset and reads the frame buffer when it wants it.
+ */
+class VideoSink
+{
+public:
+    virtual ~VideoSink() = default;
+
+    // Called once per emulated frame with the 256x240 ARGB frame buffer
+    virtual void pushFrame(const uint32_t *frameBuffer) = 0;
+};
+
+// Fed instead of a VideoSink while the console writes palette indices, a quarter of the bytes
+class IndexedVideoSink
+{
+public:
+    virtual ~IndexedVideoSink() = default;
+
+    // Called once per emulated frame with 256x240 6-bit indices into the NES palette
+    virtual void pushFrame(const uint8_t *indices) = 0;
+};
+
+class AudioSink
+{
+public:
+    virtual ~AudioSink() = default;
+
+    // Called whenever a block of mono samples has been synthesized
+    virtual void pushSamples(const blip_sample_t *samples, size_t count) = 0;
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <MachineState.hpp>
+
+/*
+ * Hands out MachineState blocks from chunks allocated a batch at a time,
+ * so many consoles (search, rewind, run-ahead) share a few allocations
+ * and released blocks are reused. Not thread safe.
+ */
+class StateArena
+{
+    const size_t blocksPerChunk;
+    std::vector<std::unique_ptr<MachineState[]>> chunks;
+    std::vector<MachineState *> freeBlocks;
+
+public:
+    explicit StateArena(size_t blocksPerChunk = 16);
+    ~StateArena() = default;
+
+    // A zeroed block, valid until released or the arena is destroyed
+    MachineState *allocate();
+    void release(MachineState *state);
+    size_t capacity() const;
+};
@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include <MachineState.hpp>
+
+/*
+ * Compact coding of a state as the XOR against a reference state, word
+ * by word: runs of unchanged words are counted, changed ones stored. A
+ * null reference stands for an all-zero block, which is how keyframes
+ * are stored. Only the live part of the block (stateBytes) is coded.
+ * Neighbouring frames differ in a few hundred bytes at most.
+ */
+static constexpr size_t MaxEncodedStateSize =
+    sizeof(uint16_t) + sizeof(MachineState) + (sizeof(MachineState) / sizeof(uint64_t) / 2 + 1) * 2 * sizeof(uint16_t);
+
+// Writes at most MaxEncodedStateSize bytes to out and returns how many
+size_t encodeState(const MachineState &state, const MachineState *reference, uint8_t *out);
+void decodeState(const uint8_t *in, const MachineState *reference, MachineState &state);
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * A TAS movie is this header, then an optional save state to start from
+ * (power-on if absent), then the input as runs: a little-endian 16-bit
+ * frame count followed by one button byte per controller, repeated that
+ * many frames. The CRC covers everything after the header, which is in
+ * host byte order like a save state.
+ */
+#define TAS_MAGIC 0x5341544E // 'NTAS'
+#define TAS_VERSION 1
+#define TAS_MAX_CONTROLLERS 4
+#define TAS_MAX_RUN 0xFFFF
+
+struct TasHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint8_t controllers;
+    uint8_t reserved;
+    uint32_t romCrc;
+    uint32_t frameCount;
+    uint32_t runCount;
+    uint32_t stateSize;
+    uint32_t crc;
+};
+
+// Builds a movie a frame at a time, merging repeated input into runs
+class TasWriter
+{
+    TasHeader header;
+    std::vector<uint8_t> startState;
+    std::vector<uint8_t> runs;
+    uint8_t last[TAS_MAX_CONTROLLERS];
+
+public:
+    TasWriter(uint32_t romCrc, uint8_t controllers = 1);
+
+    void setStartState(const std::vector<uint8_t> &state);
+    void push(const uint8_t *inputs);
+    uint32_t getFrameCount() const;
+    bool save(const std::string &path);
+};
+
+/*
+ * Plays a movie straight out of a read-only mapping of the file, so
+ * opening one costs a CRC pass over its runs no matter how long it is.
+ * Throws std::invalid_argument if the file is not a valid movie.
+ */
+class TasReader
+{
+    const uint8_t *data;
+    size_t size;
+
+    TasHeader header;
+    const uint8_t *nextRun;
+    const uint8_t *input;
+    uint32_t runsLeft;
+    uint16_t repeatsLeft;
+
+public:
+    explicit TasReader(const std::string &path);
+    ~TasReader() noexcept;
+
+    TasReader(const TasReader &) = delete;
+    TasReader &operator=(const TasReader &) = delete;
+
+    const TasHeader &getHeader() const;
+    // The save state the movie starts from, or null to start from power-on
+    const uint8_t *getStartState() const;
+    // Copies the next frame's buttons for each controller, false once the movie ends
+    bool next(uint8_t *inputs);
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Fixed set of worker threads for fork-join batches. Each batch is split
+ * evenly over per-worker queues; a worker drains its own queue from the
+ * front and, once empty, steals from the back of the others, so uneven
+ * tasks still keep every core busy.
+ */
+class ThreadPool
+{
+public:
+    typedef std::function<void(size_t task, size_t worker)> Job;
+
+private:
+    // The tasks in [begin, end) not yet taken; a batch gives each queue a contiguous range, so none allocates
+    struct Queue
+    {
+        std::mutex lock;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    std::vector<std::thread> threads;
+    std::vector<std::unique_ptr<Queue>> queues;
+
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const Job *job;
+    uint64_t batch;
+    std::atomic<size_t> remaining;
+    // Workers still inside the current batch; a new one cannot start until they leave
+    size_t active;
+    bool quit;
+
+    void work(size_t worker);
+    bool take(size_t worker, size_t &task);
+
+public:
+    // Zero threads means one per hardware thread
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool() noexcept;
+
+    size_t size() const;
+    // Calls job(task, worker) for every task in [0, count) and returns once all have finished
+    void parallelFor(size_t count, const Job &job);
+};
@@ -0,0 +1,103 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <MachineState.hpp>
+#include <ObservationFilter.hpp>
+#include <RamExpression.hpp>
+#include <ThreadPool.hpp>
+
+class NesSystem;
+
+struct EnvConfig
+{
+    enum Observation
+    {
+        RAM,       // The 2KB of CPU RAM
+        FRAME,     // The 256x240 ARGB frame buffer
+        PALETTE,   // The 256x240 frame as palette indices
+        GRAYSCALE, // 84x84 luma, the brighter of the last two frames of the step at each pixel
+    };
+
+    std::string romName;
+    size_t count = 8;
+    Observation observation = RAM;
+
+    // Rewarded by how much it grows over a step, e.g. "$6D * 256 + $86"; empty means no reward
+    std::string reward;
+    // The episode ends once this is non-zero; empty means only maxSteps ends it
+    std::string done;
+    // Steps before an episode is cut short; zero means no limit
+    uint32_t maxSteps = 0;
+
+    // Every episode starts one frame after this state, as written by NesSystem::saveState; empty means power-on
+    std::vector<uint8_t> startState;
+    // Zero means one per hardware thread
+    size_t threads = 0;
+};
+
+/*
+ * A batch of independent consoles for reinforcement learning, stepped in
+ * lockstep over a thread pool. Observations, rewards and done flags land
+ * in contiguous buffers owned by the batch, one slot per console, so a
+ * step allocates nothing. A console whose episode ends is put back at the
+ * start state within the same step, and its slot then holds the first
+ * observation of the new episode.
+ */
+class VectorEnv
+{
+    struct Env
+    {
+        std::unique_ptr<NesSystem> nes;
+        std::unique_ptr<ObservationFilter> filter;
+        int64_t score;
+        uint32_t steps;
+    };
+
+    const EnvConfig config;
+    const RamExpression reward;
+    const RamExpression done;
+
+    ThreadPool pool;
+    std::vector<Env> envs;
+
+    std::unique_ptr<MachineState> start;
+    int64_t startScore;
+    const size_t observationBytes;
+    // What a console shows at the start state, since the frame buffer is not part of it
+    std::vector<uint8_t> startObservation;
+    std::vector<uint8_t> observations;
+    std::vector<float> rewards;
+    std::vector<uint8_t> dones;
+
+    // The step being run, for the workers
+    const uint8_t *actions;
+    uint32_t frames;
+    const ThreadPool::Job stepJob;
+
+    void stepEnv(size_t env);
+    void resetEnv(size_t env);
+    const void *observation(size_t env, const uint8_t *ram) const;
+
+public:
+    // Throws std::invalid_argument for a bad expression or start state
+    explicit VectorEnv(const EnvConfig &config);
+    ~VectorEnv() noexcept;
+
+    // Puts every console back at the start state
+    void reset();
+    // Holds actions[i] on console i for the given number of frames
+    void step(const uint8_t *actions, uint32_t frames);
+
+    size_t size() const;
+    size_t observationSize() const;
+    // size() observations of observationSize() bytes each
+    const uint8_t *getObservations() const;
+    // The growth of the reward expression over the last step
+    const float *getRewards() const;
+    // Non-zero where the last step ended an episode
+    const uint8_t *getDones() const;
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <vector>
+
+/*
+ * CHR patterns decoded to one 2-bit pixel per byte, leftmost pixel in
+ * the low byte, so a whole 8-pixel row is a single load. Every row is
+ * kept as stored and mirrored horizontally for flipped sprites.
+ */
+class ChrCache
+{
+    static const std::array<uint64_t, 0x100> spread;
+
+    std::vector<uint64_t> rows;
+    std::vector<bool> dirty;
+
+    void decodeTile(const uint8_t *chr, size_t tile);
+
+public:
+    static const uint64_t blank[2];
+
+    static inline uint64_t decode(uint8_t lo, uint8_t hi)
+    {
+        return spread[lo] | (spread[hi] << 1);
+    }
+
+    void build(const uint8_t *chr, size_t size);
+    void invalidate(size_t offset);
+    void invalidateAll();
+
+    // Both variants of the row containing a CHR offset
+    inline const uint64_t *row(const uint8_t *chr, size_t offset)
+    {
+        const size_t tile = offset >> 4;
+
+        if (dirty[tile])
+            decodeTile(chr, tile);
+
+        return decoded(offset);
+    }
+
+    // The same for a cache that is never invalidated, which any number of threads may then read
+    inline const uint64_t *decoded(size_t offset) const
+    {
+        return &rows[(((offset >> 4) << 3) | (offset & 0x7)) << 1];
+    }
+};
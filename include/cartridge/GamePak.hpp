@@ -1,56 +1,133 @@
 #pragma once
 #include <string>
-#include <vector>
 #include <memory>
 
 #include <AddressableDevice.hpp>
 #include <Mapper.hpp>
+#include <ChrCache.hpp>
+#include <RomImage.hpp>
+#include <RomDatabase.hpp>
 #include <HwConstants.hpp>
 
+class RicohRP2C02;
+class Bus;
+
+// Board registers, kept in the machine's state block; its RAM follows at the block's end
+struct CartState
+{
+    // Bytes of PRG and CHR RAM the board has, a multiple of 8KB
+    uint16_t ramSize;
+    uint8_t registers[MAPPER_REGISTERS];
+    uint8_t mirrorMode;
+    // The board's IRQ output
+    bool irq;
+};
+
 class GamePak : public AddressableDevice
 {
 public:
     enum MirrorMode
     {
         VERTICAL,
-        HORIZONTAL
+        HORIZONTAL,
+        SINGLE_SCREEN_LOW,
+        SINGLE_SCREEN_HIGH,
+        FOUR_SCREEN
     };
 
-    GamePak(const std::string &fname);
+    GamePak(const std::string &fname, CartState &state, uint8_t *ram);
     GamePak::MirrorMode getMirrorMode() const;
+    void setMirrorMode(MirrorMode mode);
 
     // private:
-    enum ActiveMemory
-    {
-        PRG,
-        CHR,
-    };
-
-    typedef struct
-    {
-        uint8_t name[4];
-        uint8_t prgBanks;
-        uint8_t chrBanks;
-        uint8_t mapper1;
-        uint8_t mapper2;
-        uint8_t prgRamSize;
-        uint8_t tv1;
-        uint8_t tv2;
-        uint8_t unused[5];
-    } GameHeader;
-
+    CartState &state;
     std::unique_ptr<Mapper> mapper;
 
-    std::vector<uint8_t> prg;
-    std::vector<uint8_t> chr;
+    // ROM images never change and are shared; the rest of the cartridge lives in state
+    std::shared_ptr<const RomImage> rom;
+    const uint8_t *prg;
+    // CHR RAM is decoded per cartridge, CHR ROM once in the image
+    ChrCache chrCache;
+    // CRC-32 of the PRG and CHR ROM, without the iNES header
+    uint32_t romCrc;
+    // What the ROM database knows of this game, or nullptr
+    const RomInfo *info;
 
+    // The image's header, with CHR RAM counted as one CHR bank
     GameHeader header;
-    ActiveMemory mem;
-    MirrorMode mMode;
+    // No CHR ROM in the header means the board has 8KB of CHR RAM instead
+    bool chrRam;
+    // Boards without RAM at $6000-$7FFF read it as zero and drop writes
+    bool prgRam;
+    // Where the RAM the board has lives in the state block, or nullptr
+    uint8_t *prgRamMem;
+    uint8_t *chrRamMem;
+    // CHR ROM, or the CHR RAM in state
+    const uint8_t *chrMem;
+    // The banks the mapper selected for each 8KB window of $8000-$FFFF and 1KB window of $0000-$1FFF
+    const uint8_t *prgMap[4];
+    const uint8_t *chrMap[8];
+    // Notified when the mirroring changes so it can relayout its nametables
+    RicohRP2C02 *ppu = nullptr;
+    // Remapped when the PRG banks change, since its pages point into them
+    const Bus *bus = nullptr;
+    // Cached from the mapper, so the PPU knows whether to report A12 edges
+    bool scanlineCounter;
+    // Told when the mapper's IRQ may be due at a different time
+    void (*irqNotifier)(void *) = nullptr;
+    void *irqData = nullptr;
 
     void setByte(uint16_t addr, uint8_t data) override;
     uint8_t getByte(uint16_t addr, bool readOnly) override;
 
     uint16_t mirrorAddress(uint16_t addr, uint16_t mirror) override;
-    void parseFile(const std::string &fname);
+    uint8_t *getPage(uint16_t addr, uint16_t mirror, bool write) override;
+
+    // CPU addresses $4020-$FFFF
+    inline uint8_t readPrg(uint16_t addr) const
+    {
+        uint8_t data = 0x00;
+
+        if (addr >= CARTRIDGE::PrgRomBase)
+            data = prgMap[(addr >> 13) & 0x03][addr & (CARTRIDGE::PrgWindowSize - 1)];
+        else if (addr >= CARTRIDGE::PrgRamBase && prgRam)
+            data = prgRamMem[addr - CARTRIDGE::PrgRamBase];
+
+        return data;
+    }
+
+    // PPU addresses $0000-$1FFF
+    inline uint8_t readChr(uint16_t addr) const
+    {
+        return chrMap[addr >> 10][addr & (CARTRIDGE::ChrWindowSize - 1)];
+    }
+
+    void writePrg(uint16_t addr, uint8_t data);
+    void writeChr(uint16_t addr, uint8_t data);
+
+    const uint64_t *getChrRow(uint16_t addr);
+    // Offset into chrMem of a pattern table address
+    size_t chrOffset(uint16_t addr) const;
+    // Rebuilds what is cached outside the state block after it is overwritten
+    void stateLoaded();
+    void irqNotify(void (*notifier)(void *), void *data);
+    // For the PPU, when the timing of A12 edges changes
+    void irqTimingChanged();
+
+    inline bool irqAsserted() const
+    {
+        return state.irq;
+    }
+
+    // Called by the PPU on the dot of each rendered line where A12 rises, only for boards that count scanlines
+    inline void clockScanline()
+    {
+        mapper->clockScanline();
+    }
+
+    inline uint32_t scanlinesUntilIrq() const
+    {
+        return mapper->scanlinesUntilIrq();
+    }
+    void parseFile(const std::string &fname, uint8_t *ram);
 };
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+
+/*
+ * What is known about a game beyond its iNES header. Headers in the wild
+ * often name the wrong mapper or mirroring, so a known game's board comes
+ * from here instead, along with hints that turn on fast paths which are
+ * only safe for some games.
+ */
+struct RomInfo
+{
+    enum Hint : uint8_t
+    {
+        // Changes the picture mid-line in ways the per-line renderer misses, so every dot is run
+        DOT_RENDERER = 0x1,
+    };
+
+    // CRC-32 of the PRG and CHR ROM, without the iNES header
+    uint32_t crc;
+    uint8_t mapper;
+    // A GamePak::MirrorMode
+    uint8_t mirrorMode;
+    // 8KB banks of RAM at $6000-$7FFF; zero for boards without any
+    uint8_t prgRamBanks;
+    uint8_t hints;
+    // Where the game spins on a JMP to itself until an interrupt, or zero
+    uint16_t idleLoop;
+};
+
+// A known game's entry, found in constant time, or nullptr
+const RomInfo *findRomInfo(uint32_t crc);
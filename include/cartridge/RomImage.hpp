@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <ChrCache.hpp>
+
+struct GameHeader
+{
+    uint8_t name[4];
+    uint8_t prgBanks;
+    uint8_t chrBanks;
+    uint8_t mapper1;
+    uint8_t mapper2;
+    uint8_t prgRamSize;
+    uint8_t tv1;
+    uint8_t tv2;
+    uint8_t unused[5];
+};
+
+/*
+ * An iNES file mapped read-only, shared by every cartridge in the process
+ * built from the same contents. Images are found by a hash of the file, so
+ * loading a game that is already running costs a hash and no copies, and
+ * the mapping goes away with the last cartridge using it. Everything a
+ * cartridge can write lives in the machine's state block instead.
+ */
+class RomImage
+{
+    void *mapping;
+    size_t mappingSize;
+
+    RomImage(void *mapping, size_t mappingSize, uint64_t hash);
+
+public:
+    GameHeader header;
+    const uint8_t *prg;
+    size_t prgSize;
+    // Empty for boards with CHR RAM
+    const uint8_t *chr;
+    size_t chrSize;
+    // CRC-32 of the PRG and CHR ROM, without the iNES header
+    uint32_t crc;
+    // hash64 of the whole file, the key it is shared under
+    const uint64_t hash;
+    // CHR ROM decoded in full up front, so cartridges on any thread can read it
+    ChrCache chrCache;
+
+    RomImage(const RomImage &) = delete;
+    RomImage &operator=(const RomImage &) = delete;
+    ~RomImage() noexcept;
+
+    // Throws std::ifstream::failure if the file cannot be read or is not an iNES image
+    static std::shared_ptr<const RomImage> load(const std::string &fname);
+};
@@ -1,5 +1,4 @@
 #pragma once
-#include <SDL2/SDL.h>
 #include <MOS6502Instruction.hpp>
 #include <Ricoh2A03.hpp>
 #include <stdio.h>
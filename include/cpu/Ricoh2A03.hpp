@@ -10,23 +10,48 @@
 #define NUM_OPCODES 0x100
 #define FRAME_TICKS 29781
 
+// Build with -DSWITCH_CORE (make CORE=switch) to dispatch through SwitchCore.cpp
+#ifdef SWITCH_CORE
+#define DEFAULT_CORE Core::SWITCH
+#else
+#define DEFAULT_CORE Core::VTABLE
+#endif
+
 class GamePak;
 class AddressableDevice;
 class NesSystem;
 class GamePad;
 class Apu2A03;
+class RicohRP2C02;
+
+// CPU registers and OAM DMA progress, kept in the machine's state block
+struct CpuState
+{
+    int32_t remaining;
+    uint16_t PC;
+    uint8_t A;
+    uint8_t X;
+    uint8_t Y;
+    uint8_t SP;
+    uint8_t S;
+    uint8_t cycles;
+    uint8_t dma_page;
+    uint8_t dma_addr;
+    bool dma_transfer;
+};
 
 class Ricoh2A03
 {
 public:
+    CpuState &state;
     std::unique_ptr<Bus> bus;
 
-    std::shared_ptr<AddressableDevice> Ppu;
+    std::shared_ptr<RicohRP2C02> Ppu;
     std::shared_ptr<AddressableDevice> ram;
     std::shared_ptr<AddressableDevice> cartridge;
     std::array<std::unique_ptr<MOS6502Instruction>, NUM_OPCODES> instructions;
 
-    uint8_t cycles;
+    uint8_t &cycles = state.cycles;
 
 public:
     enum Flags6502
@@ -57,29 +82,39 @@ public:
         IY,
     };
 
-    uint8_t A;
-    uint8_t X;
-    uint8_t Y;
-    uint8_t SP;
-    uint16_t PC;
-    uint8_t S;
-    int remaining;
+    enum class Core
+    {
+        VTABLE,
+        SWITCH,
+    };
 
-    uint8_t dma_page;
-    uint8_t dma_addr;
-    bool dma_transfer;
+    uint8_t &A = state.A;
+    uint8_t &X = state.X;
+    uint8_t &Y = state.Y;
+    uint8_t &SP = state.SP;
+    uint16_t &PC = state.PC;
+    uint8_t &S = state.S;
+    int32_t &remaining = state.remaining;
+
+    uint8_t &dma_page = state.dma_page;
+    uint8_t &dma_addr = state.dma_addr;
+    bool &dma_transfer = state.dma_transfer;
 
     std::shared_ptr<Apu2A03> apu;
 
-    Ricoh2A03(std::shared_ptr<AddressableDevice> ppu, std::shared_ptr<GamePad> p1);
+    Ricoh2A03(CpuState &state, uint8_t *ramContents, std::shared_ptr<RicohRP2C02> ppu, std::shared_ptr<GamePad> p1);
     ~Ricoh2A03() = default;
 
-    uint8_t read(uint16_t addr, bool zpageMode = false);
+    inline uint8_t read(uint16_t addr, bool zpageMode = false);
     uint16_t readDoubleWord(uint16_t addr, bool zpageMode = false);
+    uint8_t readRegister(uint16_t addr);
 
-    void write(uint16_t addr, uint8_t data);
+    inline void write(uint16_t addr, uint8_t data);
+    void writeRegister(uint16_t addr, uint8_t data);
 
+    template <Core C = DEFAULT_CORE>
     void fetch();
+    uint8_t execute(uint8_t opcode);
     void reset();
     void irq();
     void nmi(uint16_t interruptAddr = 0xFFFA);
@@ -96,9 +131,34 @@ public:
     uint8_t branch(uint16_t absoluteAddress, bool cond);
     void addCartridge(std::shared_ptr<AddressableDevice> cart);
 
-    uint16_t elapsed() const;
+    inline uint16_t elapsed() const;
 
     void processFrameAudio() const;
     bool isFrameDone() const;
     void restartFrameTimer();
 };
+
+// RAM and PRG ROM pages resolve to host memory, everything else is a register access
+inline uint8_t Ricoh2A03::read(uint16_t addr, bool zpageMode)
+{
+    if (zpageMode)
+        addr &= 0x00FF;
+
+    if (const uint8_t *page = bus->readPage(addr))
+        return page[addr & 0x00FF];
+
+    return readRegister(addr);
+}
+
+inline uint16_t Ricoh2A03::elapsed() const
+{
+    return FRAME_TICKS - remaining;
+}
+
+inline void Ricoh2A03::write(uint16_t addr, uint8_t data)
+{
+    if (uint8_t *page = bus->writePage(addr))
+        page[addr & 0x00FF] = data;
+    else
+        writeRegister(addr, data);
+}
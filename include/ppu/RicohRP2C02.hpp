@@ -7,21 +7,18 @@
 #include <AddressableDevice.hpp>
 #include <GamePak.hpp>
 
-class RicohRP2C02 : public AddressableDevice
+#define SCANLINE_DOTS 341
+#define FRAME_DOTS (SCANLINE_DOTS * 262 - 1)
+#define VBLANK_SCANLINE 241
+
+/*
+ * Everything the PPU mutates while running, kept in the machine's state
+ * block (MachineState.hpp) so a whole console can be copied with memcpy.
+ * Caches derived from it, like the colour table, live in RicohRP2C02.
+ */
+struct PpuState
 {
-    uint8_t tblName[2][1024];
-    uint8_t tblPalette[32];
-    inline void scrollX();
-    inline void scrollY();
-    inline void tax();
-    inline void tay();
-    inline void loadShifters();
-    inline void updateShifters();
-
-    std::array<uint32_t, 0x40> palettes;
-    std::vector<uint32_t> sprScreen;
-
-    union {
+    union PPUSTATUS {
         struct
         {
             uint8_t unused : 5;
@@ -31,9 +28,9 @@ class RicohRP2C02 : public AddressableDevice
         };
 
         uint8_t reg;
-    } status;
+    };
 
-    union {
+    union PPUMASK {
         struct
         {
             uint8_t grayscale : 1;
@@ -47,7 +44,7 @@ class RicohRP2C02 : public AddressableDevice
         };
 
         uint8_t reg;
-    } mask;
+    };
 
     union PPUCTRL {
         struct
@@ -63,7 +60,7 @@ class RicohRP2C02 : public AddressableDevice
         };
 
         uint8_t reg;
-    } control;
+    };
 
     union loopy_register {
         struct
@@ -77,52 +74,145 @@ class RicohRP2C02 : public AddressableDevice
             uint16_t unused : 1;
         };
 
-        uint16_t reg = 0x0000;
+        uint16_t reg;
     };
 
-    loopy_register vram_addr;
-    loopy_register tram_addr;
-
-    uint8_t fine_x = 0x00;
-
-    uint8_t address_latch = 0x00;
-    uint8_t ppu_data_buffer = 0x00;
-
-    int16_t scanline = 0;
-    int16_t cycle = 0;
-
-    uint8_t bg_next_tile_id = 0x00;
-    uint8_t bg_next_tile_attrib = 0x00;
-    uint8_t bg_next_tile_lsb = 0x00;
-    uint8_t bg_next_tile_msb = 0x00;
-    uint16_t bg_shifter_pattern_lo = 0x0000;
-    uint16_t bg_shifter_pattern_hi = 0x0000;
-    uint16_t bg_shifter_attrib_lo = 0x0000;
-    uint16_t bg_shifter_attrib_hi = 0x0000;
-    GamePak *cart;
-
     struct sObjectAttributeEntry
     {
         uint8_t y;
         uint8_t id;
         uint8_t attribute;
         uint8_t x;
-    } OAM[64];
+    };
 
-    uint8_t oam_addr = 0x00;
+    // Dots run so far, and dots the rest of the system has already reached
+    uint64_t clock;
+    uint64_t pending;
+    // Pattern rows decoded by ChrCache, so each dot shifts out a byte
+    uint64_t sprite_shifter_pixels[8];
 
+    // Two pages of CIRAM, plus the two extra pages of four-screen carts
+    uint8_t tblName[4][1024];
+    uint8_t tblPalette[32];
+    sObjectAttributeEntry OAM[64];
     sObjectAttributeEntry spriteScanline[8];
+
+    uint16_t bg_shifter_pattern_lo;
+    uint16_t bg_shifter_pattern_hi;
+    uint16_t bg_shifter_attrib_lo;
+    uint16_t bg_shifter_attrib_hi;
+    loopy_register vram_addr;
+    loopy_register tram_addr;
+    int16_t scanline;
+    int16_t cycle;
+
+    PPUSTATUS status;
+    PPUMASK mask;
+    PPUCTRL control;
+    uint8_t fine_x;
+    uint8_t address_latch;
+    uint8_t ppu_data_buffer;
+    uint8_t oam_addr;
     uint8_t sprite_count;
-    uint8_t sprite_shifter_pattern_lo[8];
-    uint8_t sprite_shifter_pattern_hi[8];
+    uint8_t bg_next_tile_id;
+    uint8_t bg_next_tile_attrib;
+    uint8_t bg_next_tile_lsb;
+    uint8_t bg_next_tile_msb;
+    bool bSpriteZeroHitPossible;
+    bool bSpriteZeroBeingRendered;
+    bool requestCpuNmi;
+};
+
+class RicohRP2C02 : public AddressableDevice
+{
+    PpuState &state;
+
+    uint8_t (&tblName)[4][1024] = state.tblName;
+    // $2000-$2FFF in 1KB pages, laid out by the cartridge's mirroring
+    uint8_t *nametable[4];
+    uint8_t (&tblPalette)[32] = state.tblPalette;
+    inline void scrollX();
+    inline void scrollY();
+    inline void tax();
+    inline void tay();
+    inline void loadShifters();
+    inline void updateShifters();
+    inline void renderScanline();
+    inline void idleScanline();
+    inline void updateColour(uint8_t entry);
+    void updateColourTable();
+    void updateScanlineClock();
+
+    inline bool renderingEnabled() const
+    {
+        return mask.render_background || mask.render_sprites;
+    }
+
+    inline void clockScanlineCounter()
+    {
+        if (renderingEnabled())
+            cart->clockScanline();
+    }
+
+    std::array<uint32_t, 0x40> palettes;
+    // palettes[] resolved for each of the 32 palette RAM entries, mirrors included
+    uint32_t colourTable[0x20];
+    // The same as indices into palettes[]
+    uint8_t indexTable[0x20];
+    std::vector<uint32_t> sprScreen;
+    std::vector<uint8_t> indexScreen;
+
+    PpuState::PPUSTATUS &status = state.status;
+    PpuState::PPUMASK &mask = state.mask;
+    PpuState::PPUCTRL &control = state.control;
+
+    PpuState::loopy_register &vram_addr = state.vram_addr;
+    PpuState::loopy_register &tram_addr = state.tram_addr;
+
+    uint8_t &fine_x = state.fine_x;
+
+    uint8_t &address_latch = state.address_latch;
+    uint8_t &ppu_data_buffer = state.ppu_data_buffer;
+
+    int16_t &scanline = state.scanline;
+    int16_t &cycle = state.cycle;
+
+    uint8_t &bg_next_tile_id = state.bg_next_tile_id;
+    uint8_t &bg_next_tile_attrib = state.bg_next_tile_attrib;
+    uint8_t &bg_next_tile_lsb = state.bg_next_tile_lsb;
+    uint8_t &bg_next_tile_msb = state.bg_next_tile_msb;
+    uint16_t &bg_shifter_pattern_lo = state.bg_shifter_pattern_lo;
+    uint16_t &bg_shifter_pattern_hi = state.bg_shifter_pattern_hi;
+    uint16_t &bg_shifter_attrib_lo = state.bg_shifter_attrib_lo;
+    uint16_t &bg_shifter_attrib_hi = state.bg_shifter_attrib_hi;
+    GamePak *cart;
+
+    PpuState::sObjectAttributeEntry (&OAM)[64] = state.OAM;
+
+    uint8_t &oam_addr = state.oam_addr;
+
+    PpuState::sObjectAttributeEntry (&spriteScanline)[8] = state.spriteScanline;
+    uint8_t &sprite_count = state.sprite_count;
+    uint64_t (&sprite_shifter_pixels)[8] = state.sprite_shifter_pixels;
+
+    bool &bSpriteZeroHitPossible = state.bSpriteZeroHitPossible;
+    bool &bSpriteZeroBeingRendered = state.bSpriteZeroBeingRendered;
+
+    uint64_t &clock = state.clock;
+    uint64_t &pending = state.pending;
+    bool scanlineRenderer = true;
+    // The dot of each rendered line where A12 rises for a cartridge that counts scanlines, or -1
+    int16_t scanlineClockDot = -1;
+    // Pixels go to indexScreen as palette indices instead of sprScreen as colours
+    bool indexedOutput = false;
 
-    bool bSpriteZeroHitPossible = false;
-    bool bSpriteZeroBeingRendered = false;
-    
 public:
-    RicohRP2C02();
+    explicit RicohRP2C02(PpuState &state);
     ~RicohRP2C02();
     uint32_t *getFrameBuffData();
+    const uint8_t *getIndexBuffData() const;
+    // The 64 ARGB colours palette indices refer to
+    const uint32_t *getPalette() const;
     uint32_t GetColourFromPaletteRam(uint8_t palette, uint8_t pixel);
     uint8_t *pOAM = (uint8_t *)OAM;
 
@@ -133,7 +223,17 @@ public:
     void localWrite(uint16_t addr, uint8_t data);
 
     void addCartridge(const std::shared_ptr<AddressableDevice> cartridge);
+    void updateNametablePages();
+    // Rebuilds what is cached outside the state block after it is overwritten
+    void stateLoaded();
     void run();
+    void deferUntil(uint64_t dot);
+    void catchUp();
+    void setScanlineRenderer(bool enabled);
+    void setIndexedOutput(bool enabled);
     void reset();
-    bool requestCpuNmi = false;
-};
+    uint32_t dotsUntil(int16_t targetScanline, int16_t targetCycle) const;
+    uint32_t dotsUntilScanlineClock(uint32_t clocks) const;
+    uint64_t getClock() const;
+    bool &requestCpuNmi = state.requestCpuNmi;
+};
\ No newline at end of file
@@ -1,6 +1,5 @@
 #pragma once
 #include <AddressableDevice.hpp>
-#include <vector>
 
 /*
  * NES RAM's address space is 8KB, but it is only 2KB in size
@@ -12,11 +11,14 @@
 class Ram : public AddressableDevice
 {
 protected:
-    std::vector<uint8_t> contents;
+    // Owned by the caller, normally the machine's state block
+    uint8_t *contents;
     void setByte(uint16_t addr, uint8_t data) override;
     uint8_t getByte(uint16_t addr, bool readOnly) override;
 
 public:
-    explicit Ram(const uint16_t size);
+    explicit Ram(uint8_t *contents);
     virtual ~Ram() = default;
+
+    uint8_t *getPage(uint16_t addr, uint16_t mirror, bool write) override;
 };
\ No newline at end of file
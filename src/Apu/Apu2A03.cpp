@@ -1,9 +1,11 @@
 #include <Apu2A03.hpp>
 
-Apu2A03::Apu2A03()
+Apu2A03::Apu2A03() : sink{nullptr}, muted{false}
 {
     buf.sample_rate(96000);
     buf.clock_rate(1789773);
+    discard.sample_rate(96000);
+    discard.clock_rate(1789773);
 
     apu.output(&buf);
     apu.dmc_reader(func);
@@ -25,8 +27,29 @@ template uint8_t Apu2A03::access<1>(int, uint16_t, uint8_t);
 void Apu2A03::run_frame(int elapsed)
 {
     apu.end_frame(elapsed);
+    if (muted)
+    {
+        discard.end_frame(elapsed);
+        discard.clear(false);
+        return;
+    }
     buf.end_frame(elapsed);
 
     if (buf.samples_avail() >= OUT_SIZE)
-        newSamples(outBuf, buf.read_samples(outBuf, OUT_SIZE));
-}
\ No newline at end of file
+    {
+        const long count = buf.read_samples(outBuf, OUT_SIZE);
+        if (sink)
+            sink->pushSamples(outBuf, count);
+    }
+}
+/*
+ * A muted APU synthesizes into a scratch buffer emptied after every frame, so
+ * frames that are later undone leave no trace in the output. The
+ * oscillators stop their timers without any output at all, which would
+ * make muted frames diverge from heard ones.
+ */
+void Apu2A03::setMuted(bool mute)
+{
+    muted = mute;
+    apu.output(mute ? &discard : &buf);
+}
@@ -120,5 +120,17 @@ void Nes_Apu::load_snapshot( apu_snapshot_t const& state )
 	refl::reflect_dmc     ( st.dmc,         dmc );
 	dmc.recalc_irq();
 	dmc.last_amp = dmc.dac;
+	irq_changed(); // irq_flag was set behind its back
 }
 
+
+cpu_time_t Nes_Apu::next_frame_irq() const
+{
+	return next_irq;
+}
+
+void Nes_Apu::set_next_frame_irq( cpu_time_t time )
+{
+	next_irq = time;
+	irq_changed();
+}
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#include <BeamSearch.hpp>
+#include <NesSystem.hpp>
+#include <TasMovie.hpp>
+#include <Hash64.hpp>
+
+void playPrefixMovie(NesSystem &nes, const std::string &path, std::vector<uint8_t> &startState, std::vector<uint8_t> &prefix)
+{
+    TasReader movie(path);
+    uint8_t inputs[TAS_MAX_CONTROLLERS];
+
+    if (movie.getHeader().romCrc != nes.getRomCrc())
+        throw std::invalid_argument("The prefix movie was recorded on a different ROM");
+    if (movie.getStartState())
+    {
+        startState.assign(movie.getStartState(), movie.getStartState() + movie.getHeader().stateSize);
+        if (!nes.loadState(startState))
+            throw std::invalid_argument("The prefix movie starts from a save state this build cannot load");
+    }
+
+    while (movie.next(inputs))
+    {
+        prefix.push_back(inputs[0]);
+        nes.setGameplayInput(inputs[0]);
+        nes.runFrame();
+    }
+}
+
+BeamSearch::BeamSearch(const SearchConfig &config)
+    : config{config}, fitness{config.fitness}, pool{config.threads}, bestPath{0}, depth{0}, transpositions{0}
+{
+    actions = config.actions.empty() ? defaultActions() : config.actions;
+
+    for (size_t i = 0; i < pool.size(); ++i)
+    {
+        consoles.emplace_back(new NesSystem{NesSystem::PLAY});
+        consoles.back()->insertCartridge(config.romName);
+    }
+
+    NesSystem &root = *consoles[0];
+    romCrc = root.getRomCrc();
+
+    if (!config.prefixMovie.empty())
+        playPrefixMovie(root, config.prefixMovie, startState, prefix);
+
+    Node start{arena.allocate(), 0, 0};
+    const MachineState &rootState = root.captureState();
+    std::memcpy(start.state, &rootState, stateBytes(rootState));
+    start.fitness = fitness.evaluate(start.state->ram);
+
+    beam.push_back(start);
+    paths.push_back(PathStep{0, 0});
+    seen.insert(hashState(*start.state));
+    bestFitness = start.fitness;
+}
+
+BeamSearch::~BeamSearch() noexcept
+{
+    for (Node &node : beam)
+        arena.release(node.state);
+}
+
+const std::vector<uint8_t> &BeamSearch::defaultActions()
+{
+    static const std::vector<uint8_t> actions{0x00, 0x01, 0x41, 0x81, 0xC1, 0x80, 0x02};
+
+    return actions;
+}
+
+static_assert(offsetof(CpuState, remaining) == 0 && offsetof(PpuState, pending) == offsetof(PpuState, clock) + sizeof(uint64_t),
+              "hashState skips the timing fields as two ranges");
+
+// Clocks and frame counters differ between any two depths, so leave them out to catch states reached sooner
+uint64_t BeamSearch::hashState(const MachineState &state)
+{
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&state);
+    // Skipped: the system block, then the CPU's frame timer, and later the PPU's dot clocks
+    const size_t cpu = offsetof(MachineState, cpu.remaining) + sizeof(state.cpu.remaining);
+    const size_t clocks = offsetof(MachineState, ppu.clock);
+    const size_t rest = offsetof(MachineState, ppu.pending) + sizeof(state.ppu.pending);
+
+    return hash64(bytes + rest, stateBytes(state) - rest, hash64(bytes + cpu, clocks - cpu));
+}
+
+void BeamSearch::expand(size_t task, size_t worker)
+{
+    NesSystem &nes = *consoles[worker];
+    const Node &parent = beam[task / actions.size()];
+    const uint8_t action = actions[task % actions.size()];
+    Node &child = children[task];
+
+    nes.restoreState(*parent.state);
+    nes.setGameplayInput(action);
+    for (uint32_t i = 0; i < config.hold; ++i)
+        nes.runFrame();
+
+    const MachineState &state = nes.captureState();
+    std::memcpy(child.state, &state, stateBytes(state));
+    child.fitness = fitness.evaluate(child.state->ram);
+    childHashes[task] = hashState(*child.state);
+}
+
+bool BeamSearch::step()
+{
+    if (beam.empty() || (depth + 1) * config.hold > config.frames)
+        return false;
+
+    const size_t count = beam.size() * actions.size();
+
+    children.resize(count);
+    childHashes.resize(count);
+    for (Node &child : children)
+        child.state = arena.allocate();
+
+    pool.parallelFor(count, [this](size_t task, size_t worker) { expand(task, worker); });
+
+    // Children are visited in task order, so the search gives the same result on any number of threads
+    std::vector<Node> kept;
+    for (size_t task = 0; task < count; ++task)
+    {
+        Node &child = children[task];
+
+        if (!seen.insert(childHashes[task]).second)
+        {
+            arena.release(child.state);
+            ++transpositions;
+            continue;
+        }
+
+        paths.push_back(PathStep{beam[task / actions.size()].path, actions[task % actions.size()]});
+        child.path = paths.size() - 1;
+        kept.push_back(child);
+    }
+
+    std::stable_sort(kept.begin(), kept.end(), [](const Node &a, const Node &b) { return a.fitness > b.fitness; });
+    for (size_t i = config.beamWidth; i < kept.size(); ++i)
+        arena.release(kept[i].state);
+    if (kept.size() > config.beamWidth)
+        kept.resize(config.beamWidth);
+
+    for (Node &node : beam)
+        arena.release(node.state);
+    beam.swap(kept);
+
+    ++depth;
+    if (!beam.empty() && beam.front().fitness > bestFitness)
+    {
+        bestFitness = beam.front().fitness;
+        bestPath = beam.front().path;
+    }
+
+    return !beam.empty();
+}
+
+uint32_t BeamSearch::getFrame() const
+{
+    return depth * config.hold;
+}
+
+int64_t BeamSearch::getBestFitness() const
+{
+    return bestFitness;
+}
+
+size_t BeamSearch::getTranspositions() const
+{
+    return transpositions;
+}
+
+std::vector<uint8_t> BeamSearch::getBestInput() const
+{
+    std::vector<uint8_t> steps;
+
+    for (uint32_t path = bestPath; path != 0; path = paths[path].parent)
+        steps.push_back(paths[path].action);
+
+    std::vector<uint8_t> input = prefix;
+    for (auto action = steps.rbegin(); action != steps.rend(); ++action)
+        input.insert(input.end(), config.hold, *action);
+
+    return input;
+}
+
+bool BeamSearch::saveMovie(const std::string &path) const
+{
+    TasWriter movie(romCrc);
+
+    if (!startState.empty())
+        movie.setStartState(startState);
+    for (uint8_t input : getBestInput())
+        movie.push(&input);
+
+    return movie.save(path);
+}
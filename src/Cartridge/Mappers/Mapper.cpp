@@ -1,4 +1,40 @@
+#include <cstring>
+
 #include <Mapper.hpp>
+#include <GamePak.hpp>
+
+Mapper::Mapper(GamePak &cart)
+    : cart{cart}, prgBanks{cart.header.prgBanks}, chrBanks{cart.header.chrBanks}, registers{cart.state.registers} {}
+
+void Mapper::reset()
+{
+    std::memset(registers, 0x00, sizeof(registers));
+}
+
+void Mapper::mapPrg(uint8_t window, int32_t bank, uint8_t size)
+{
+    const int32_t count = prgBanks * (CARTRIDGE::PrgBankSize / CARTRIDGE::PrgWindowSize);
+
+    for (uint8_t i = 0; i < size; ++i)
+        cart.prgMap[window + i] = &cart.prg[((bank * size + i) % count + count) % count * CARTRIDGE::PrgWindowSize];
+}
+
+void Mapper::mapChr(uint8_t window, int32_t bank, uint8_t size)
+{
+    const int32_t count = chrBanks * (CARTRIDGE::ChrBankSize / CARTRIDGE::ChrWindowSize);
+
+    for (uint8_t i = 0; i < size; ++i)
+        cart.chrMap[window + i] = &cart.chrMem[((bank * size + i) % count + count) % count * CARTRIDGE::ChrWindowSize];
+}
+
+bool Mapper::countsScanlines() const
+{
+    return false;
+}
+
+void Mapper::clockScanline() {}
 
-Mapper::Mapper(const uint8_t prgBanks, const uint8_t chrBanks)
-    : prgBanks{prgBanks}, chrBanks{chrBanks} {}
\ No newline at end of file
+uint32_t Mapper::scanlinesUntilIrq() const
+{
+    return 0;
+}
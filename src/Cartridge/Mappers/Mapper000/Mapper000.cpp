@@ -1,32 +1,19 @@
 #include <Mapper000.hpp>
 
-Mapper000::Mapper000(const uint8_t prgBanks, const uint8_t chrBanks)
-    : Mapper::Mapper(prgBanks, chrBanks) {}
+Mapper000::Mapper000(GamePak &cart)
+    : Mapper::Mapper(cart) {}
 
-bool Mapper000::translatePrgAddress(uint16_t &addr) const
+uint8_t Mapper000::writeRegister(uint16_t addr, uint8_t data)
 {
-    bool addressable = false;
-    addr += CPU::CARTRIDGE::Base;
+    (void)addr;
+    (void)data;
 
-    if (M000::PRG::Base <= addr && M000::PRG::Limit >= addr)
-    {
-        addressable = true;
-        addr = (addr - M000::PRG::Base) & (prgBanks > 0x1 ? 0x7FFF : 0x3FFF);
-    }
-
-    return addressable;
+    return NONE;
 }
 
-bool Mapper000::translateChrAddress(uint16_t &addr) const
+void Mapper000::updateBanks()
 {
-    bool addressable = false;
-    addr += PPU::CARTRIDGE::Base;
-
-    if (M000::CHR::Base <= addr && M000::CHR::Limit >= addr)
-    {
-        addressable = true;
-        addr -= M000::CHR::Base;
-    }
-
-    return addressable;
-}
\ No newline at end of file
+    // 16KB boards see their only bank twice
+    mapPrg(0, 0, 4);
+    mapChr(0, 0, 8);
+}
@@ -0,0 +1,85 @@
+#include <Mapper001.hpp>
+#include <GamePak.hpp>
+
+// An empty shift register; the marker bit reaching bit 0 means four bits are in
+#define MMC1_SHIFT_RESET 0x10
+
+Mapper001::Mapper001(GamePak &cart)
+    : Mapper::Mapper(cart) {}
+
+void Mapper001::reset()
+{
+    Mapper::reset();
+    shift = MMC1_SHIFT_RESET;
+    // The last bank is fixed at $C000 at power-on
+    control = 0x0C;
+}
+
+uint8_t Mapper001::writeRegister(uint16_t addr, uint8_t data)
+{
+    static const GamePak::MirrorMode mirrorModes[4] = {GamePak::SINGLE_SCREEN_LOW, GamePak::SINGLE_SCREEN_HIGH,
+                                                       GamePak::VERTICAL, GamePak::HORIZONTAL};
+
+    if (data & 0x80)
+    {
+        shift = MMC1_SHIFT_RESET;
+        control |= 0x0C;
+        return PRG_BANKS;
+    }
+
+    const bool full = shift & 0x01;
+    shift = (shift >> 1) | ((data & 0x01) << 4);
+    if (!full)
+        return NONE;
+
+    const uint8_t value = shift;
+    shift = MMC1_SHIFT_RESET;
+
+    switch ((addr >> 13) & 0x03)
+    {
+    case 0:
+        control = value;
+        cart.setMirrorMode(mirrorModes[control & 0x03]);
+        return PRG_BANKS | CHR_BANKS;
+    case 1:
+        chrBank0 = value;
+        return prgBanks > 0x10 ? PRG_BANKS | CHR_BANKS : CHR_BANKS;
+    case 2:
+        chrBank1 = value;
+        return CHR_BANKS;
+    default:
+        prgBank = value;
+        return PRG_BANKS;
+    }
+}
+
+void Mapper001::updateBanks()
+{
+    const uint8_t outer = prgBanks > 0x10 ? chrBank0 & 0x10 : 0x00;
+
+    switch ((control >> 2) & 0x03)
+    {
+    case 0:
+    case 1:
+        mapPrg(0, (outer | (prgBank & 0x0E)) >> 1, 4);
+        break;
+    case 2:
+        mapPrg(0, outer, 2);
+        mapPrg(2, outer | (prgBank & 0x0F), 2);
+        break;
+    default:
+        mapPrg(0, outer | (prgBank & 0x0F), 2);
+        mapPrg(2, outer | 0x0F, 2);
+        break;
+    }
+
+    if (control & 0x10)
+    {
+        mapChr(0, chrBank0, 4);
+        mapChr(4, chrBank1, 4);
+    }
+    else
+    {
+        mapChr(0, chrBank0 >> 1, 8);
+    }
+}
@@ -0,0 +1,19 @@
+#include <Mapper002.hpp>
+
+Mapper002::Mapper002(GamePak &cart)
+    : Mapper::Mapper(cart) {}
+
+uint8_t Mapper002::writeRegister(uint16_t addr, uint8_t data)
+{
+    (void)addr;
+
+    prgBank = data;
+    return PRG_BANKS;
+}
+
+void Mapper002::updateBanks()
+{
+    mapPrg(0, prgBank, 2);
+    mapPrg(2, -1, 2);
+    mapChr(0, 0, 8);
+}
@@ -0,0 +1,18 @@
+#include <Mapper003.hpp>
+
+Mapper003::Mapper003(GamePak &cart)
+    : Mapper::Mapper(cart) {}
+
+uint8_t Mapper003::writeRegister(uint16_t addr, uint8_t data)
+{
+    (void)addr;
+
+    chrBank = data;
+    return CHR_BANKS;
+}
+
+void Mapper003::updateBanks()
+{
+    mapPrg(0, 0, 4);
+    mapChr(0, chrBank, 8);
+}
@@ -0,0 +1,100 @@
+#include <Mapper004.hpp>
+#include <GamePak.hpp>
+
+Mapper004::Mapper004(GamePak &cart)
+    : Mapper::Mapper(cart) {}
+
+uint8_t Mapper004::writeRegister(uint16_t addr, uint8_t data)
+{
+    uint8_t update = NONE;
+
+    switch (addr & 0xE001)
+    {
+    case 0x8000:
+        bankSelect = data;
+        update = PRG_BANKS | CHR_BANKS;
+        break;
+    case 0x8001:
+        banks[bankSelect & 0x07] = data;
+        update = (bankSelect & 0x07) >= 6 ? PRG_BANKS : CHR_BANKS;
+        break;
+    case 0xA000:
+        if (cart.getMirrorMode() != GamePak::FOUR_SCREEN)
+            cart.setMirrorMode((data & 0x01) ? GamePak::HORIZONTAL : GamePak::VERTICAL);
+        break;
+    case 0xC000:
+        irqLatch = data;
+        update = IRQ;
+        break;
+    case 0xC001:
+        irqCounter = 0;
+        irqReload = 1;
+        update = IRQ;
+        break;
+    case 0xE000:
+        // Disabling also acknowledges
+        irqEnabled = 0;
+        cart.state.irq = false;
+        update = IRQ;
+        break;
+    case 0xE001:
+        irqEnabled = 1;
+        update = IRQ;
+        break;
+    default:
+        // PRG RAM protection is not emulated
+        break;
+    }
+
+    return update;
+}
+
+void Mapper004::updateBanks()
+{
+    const bool prgSwap = bankSelect & 0x40;
+    // The 2KB banks sit at $1000 when CHR is inverted
+    const uint8_t chrHalf = (bankSelect & 0x80) ? 4 : 0;
+
+    mapPrg(prgSwap ? 2 : 0, banks[6], 1);
+    mapPrg(1, banks[7], 1);
+    mapPrg(prgSwap ? 0 : 2, -2, 1);
+    mapPrg(3, -1, 1);
+
+    mapChr(chrHalf, banks[0] >> 1, 2);
+    mapChr(chrHalf + 2, banks[1] >> 1, 2);
+    for (uint8_t i = 0; i < 4; ++i)
+        mapChr((chrHalf ^ 4) + i, banks[2 + i], 1);
+}
+
+bool Mapper004::countsScanlines() const
+{
+    return true;
+}
+
+void Mapper004::clockScanline()
+{
+    if (irqCounter == 0 || irqReload)
+    {
+        irqCounter = irqLatch;
+        irqReload = 0;
+    }
+    else
+    {
+        --irqCounter;
+    }
+
+    if (irqCounter == 0 && irqEnabled)
+        cart.state.irq = true;
+}
+
+uint32_t Mapper004::scanlinesUntilIrq() const
+{
+    if (!irqEnabled)
+        return 0;
+
+    // A reload takes an edge of its own, and a latch of zero raises the IRQ on every edge
+    if (irqCounter == 0 || irqReload)
+        return irqLatch + 1u;
+
+    return irqCounter;
+}
@@ -0,0 +1,26 @@
+#include <Mapper007.hpp>
+#include <GamePak.hpp>
+
+Mapper007::Mapper007(GamePak &cart)
+    : Mapper::Mapper(cart) {}
+
+void Mapper007::reset()
+{
+    Mapper::reset();
+    cart.setMirrorMode(GamePak::SINGLE_SCREEN_LOW);
+}
+
+uint8_t Mapper007::writeRegister(uint16_t addr, uint8_t data)
+{
+    (void)addr;
+
+    bankSelect = data;
+    cart.setMirrorMode((data & 0x10) ? GamePak::SINGLE_SCREEN_HIGH : GamePak::SINGLE_SCREEN_LOW);
+    return PRG_BANKS;
+}
+
+void Mapper007::updateBanks()
+{
+    mapPrg(0, bankSelect & 0x07, 4);
+    mapChr(0, 0, 8);
+}
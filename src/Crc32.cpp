@@ -0,0 +1,29 @@
+#include <array>
+
+#include <Crc32.hpp>
+
+static std::array<uint32_t, 256> makeTable()
+{
+    std::array<uint32_t, 256> table;
+
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t c = i;
+        for (int bit = 0; bit < 8; ++bit)
+            c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+        table[i] = c;
+    }
+
+    return table;
+}
+
+uint32_t crc32(const uint8_t *data, size_t size, uint32_t crc)
+{
+    static const std::array<uint32_t, 256> table = makeTable();
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+
+    return ~crc;
+}
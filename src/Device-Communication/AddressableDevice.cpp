@@ -15,4 +15,13 @@ uint8_t AddressableDevice::read(uint16_t addr, uint16_t mirror, bool readOnly)
 {
     addr = mirrorAddress(addr, mirror);
     return getByte(addr, readOnly);
+}
+
+uint8_t *AddressableDevice::getPage(uint16_t addr, uint16_t mirror, bool write)
+{
+    (void)addr;
+    (void)mirror;
+    (void)write;
+
+    return nullptr;
 }
\ No newline at end of file
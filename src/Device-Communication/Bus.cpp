@@ -46,4 +46,9 @@ void Bus::attachDevice(const uint16_t base, const uint16_t limit,
         .limit = limit,
         .mirror = mirror,
         .device = device});
+}
+
+void Bus::remap(uint16_t first, uint16_t last) const
+{
+    mmu->remap(first, last);
 }
\ No newline at end of file
@@ -1,78 +1,13 @@
 #include <GamePad.hpp>
-#include <iostream>
 
-GamePad::GamePad() : buttonReg{0x00}, buttonState{0x00} {}
+GamePad::GamePad(PadState &state) : state{state} {}
 
-void GamePad::registerInputStateChange(const SDL_Event &e)
+void GamePad::registerInputStateChange(const uint8_t btn, const bool pressed)
 {
-    switch (e.type)
-    {
-    case SDL_KEYDOWN:
-
-        switch (e.key.keysym.sym)
-        {
-        case SDLK_LEFT: // D-pad
-            buttonReg |= 0x02;
-            break;
-        case SDLK_RIGHT:
-            buttonReg |= 0x01;
-            break;
-        case SDLK_UP:
-            buttonReg |= 0x08;
-            break;
-        case SDLK_DOWN:
-            buttonReg |= 0x04;
-            break;
-        case SDLK_a: // A
-            buttonReg |= 0x80;
-            break;
-        case SDLK_s: // B
-            buttonReg |= 0x40;
-            break;
-        case SDLK_z: // Start
-            buttonReg |= 0x10;
-            break;
-        case SDLK_x: // Select
-            buttonReg |= 0x20;
-            break;
-        default:
-            break;
-        }
-        break;
-    case SDL_KEYUP:
-        switch (e.key.keysym.sym)
-        {
-        case SDLK_LEFT: // D-pad
-            buttonReg &= ~0x02;
-            break;
-        case SDLK_RIGHT:
-            buttonReg &= ~0x01;
-            break;
-        case SDLK_UP:
-            buttonReg &= ~0x08;
-            break;
-        case SDLK_DOWN:
-            buttonReg &= ~0x04;
-            break;
-        case SDLK_a: // A
-            buttonReg &= ~0x80;
-            break;
-        case SDLK_s: // B
-            buttonReg &= ~0x40;
-            break;
-        case SDLK_z: // Start
-            buttonReg &= ~0x10;
-            break;
-        case SDLK_x: // Select
-            buttonReg &= ~0x20;
-            break;
-        default:
-            break;
-        }
-        break;
-    default:
-        break;
-    }
+    if (pressed)
+        buttonReg |= btn;
+    else
+        buttonReg &= ~btn;
 }
 
 void GamePad::writeButtonState()
@@ -83,7 +18,6 @@ void GamePad::writeButtonState()
 void GamePad::setPressRegister(const uint8_t btns)
 {
     buttonReg = btns;
-    std::cerr << std::hex << ((int)buttonReg) << std::endl;
 }
 
 uint8_t GamePad::readStateMSB()
@@ -96,4 +30,4 @@ uint8_t GamePad::readStateMSB()
 uint8_t GamePad::readPressReg() const
 {
     return buttonReg;
-}
\ No newline at end of file
+}
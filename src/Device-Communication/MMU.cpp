@@ -1,22 +1,65 @@
 #include <MMU.hpp>
 #include <AddressableDevice.hpp>
 
+MMU::MMU()
+{
+    pages.fill(PageEntry{nullptr, nullptr, nullptr});
+}
+
 void MMU::addEntry(const AddressingInfo entry)
 {
     virtToPhys.emplace_back(entry);
+    remap();
+}
+
+// Must be called whenever a device changes what backs its pages (e.g. a mapper bank switch)
+void MMU::remap(uint16_t first, uint16_t last)
+{
+    for (uint16_t page = first >> 8; page <= last >> 8; ++page)
+    {
+        uint16_t base = page << 8;
+        uint16_t limit = base | 0x00FF;
+
+        pages[page] = PageEntry{nullptr, nullptr, nullptr};
+
+        for (size_t i = 0; i < virtToPhys.size(); ++i)
+        {
+            if (base >= virtToPhys[i].base && limit <= virtToPhys[i].limit)
+            {
+                const uint16_t offset = base - virtToPhys[i].base;
+
+                pages[page].read = virtToPhys[i].device->getPage(offset, virtToPhys[i].mirror, false);
+                pages[page].write = virtToPhys[i].device->getPage(offset, virtToPhys[i].mirror, true);
+                pages[page].handler = &virtToPhys[i];
+                break;
+            }
+        }
+    }
 }
 
 uint8_t MMU::read(uint16_t addr)
 {
+    const PageEntry &page = pages[addr >> 8];
     uint8_t data = 0x00;
 
-    for (size_t i = 0; i < virtToPhys.size(); ++i)
+    if (page.read)
+    {
+        data = page.read[addr & 0x00FF];
+    }
+    else if (page.handler)
     {
-        if (addr <= virtToPhys[i].limit && addr >= virtToPhys[i].base)
+        data = page.handler->device->read(addr - page.handler->base, page.handler->mirror);
+    }
+    else
+    {
+        for (size_t i = 0; i < virtToPhys.size(); ++i)
         {
-            addr -= virtToPhys[i].base;
-            data = virtToPhys[i].device->read(addr, virtToPhys[i].mirror);
-            break;
+            if (addr <= virtToPhys[i].limit && addr >= virtToPhys[i].base)
+            {
+                addr -= virtToPhys[i].base;
+                data = virtToPhys[i].device->read(addr, virtToPhys[i].mirror);
+                break;
+            }
         }
     }
 
@@ -25,13 +68,26 @@ uint8_t MMU::read(uint16_t addr)
 
 void MMU::write(uint16_t addr, uint8_t data)
 {
-    for (size_t i = 0; i < virtToPhys.size(); ++i)
+    const PageEntry &page = pages[addr >> 8];
+
+    if (page.write)
     {
-        if (addr <= virtToPhys[i].limit && addr >= virtToPhys[i].base)
+        page.write[addr & 0x00FF] = data;
+    }
+    else if (page.handler)
+    {
+        page.handler->device->write(addr - page.handler->base, page.handler->mirror, data);
+    }
+    else
+    {
+        for (size_t i = 0; i < virtToPhys.size(); ++i)
         {
-            addr -= virtToPhys[i].base;
-            virtToPhys[i].device->write(addr, virtToPhys[i].mirror, data);
-            break;
+            if (addr <= virtToPhys[i].limit && addr >= virtToPhys[i].base)
+            {
+                addr -= virtToPhys[i].base;
+                virtToPhys[i].device->write(addr, virtToPhys[i].mirror, data);
+                break;
+            }
         }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,118 @@
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <ForkExplorer.hpp>
+#include <NesSystem.hpp>
+#include <RamExpression.hpp>
+
+namespace
+{
+struct BranchReport
+{
+    uint32_t branch;
+    int64_t fitness;
+    uint8_t ram[CPU::RAM::Size];
+};
+} // namespace
+
+static_assert(sizeof(BranchReport) <= PIPE_BUF, "Reports from different children must reach the pipe whole");
+
+ForkExplorer::ForkExplorer(NesSystem &nes, const RamExpression &fitness, size_t maxChildren)
+    : nes{nes}, fitness{fitness}, maxChildren{maxChildren ? maxChildren : 1}
+{
+}
+
+void ForkExplorer::runChild(uint32_t branch, const std::vector<uint8_t> &suffix, int out)
+{
+    BranchReport report;
+
+    for (uint8_t input : suffix)
+    {
+        nes.setGameplayInput(input);
+        nes.skipFrame();
+    }
+
+    report.branch = branch;
+    std::memcpy(report.ram, nes.captureState().ram, sizeof(report.ram));
+    report.fitness = fitness.evaluate(report.ram);
+
+    const bool sent = write(out, &report, sizeof(report)) == sizeof(report);
+
+    // Destructors and atexit handlers belong to the parent, which still owns the window, files and threads
+    _exit(sent ? 0 : 1);
+}
+
+std::vector<BranchResult> ForkExplorer::explore(const std::vector<std::vector<uint8_t>> &suffixes)
+{
+    std::vector<BranchResult> results(suffixes.size());
+    std::unordered_map<pid_t, uint32_t> children;
+    size_t next = 0;
+    int channel[2];
+
+    if (pipe(channel) != 0)
+        throw std::runtime_error(std::string("Cannot open a pipe for the branches: ") + std::strerror(errno));
+    fcntl(channel[0], F_SETFL, O_NONBLOCK);
+
+    while (next < suffixes.size() || !children.empty())
+    {
+        while (next < suffixes.size() && children.size() < maxChildren)
+        {
+            const pid_t pid = fork();
+
+            if (pid == 0)
+            {
+                close(channel[0]);
+                runChild(next, suffixes[next], channel[1]);
+            }
+            if (pid < 0)
+            {
+                if (!children.empty())
+                    break; // At the process limit; try again as children exit
+
+                close(channel[0]);
+                close(channel[1]);
+                throw std::runtime_error(std::string("Cannot fork a branch: ") + std::strerror(errno));
+            }
+
+            children[pid] = next++;
+        }
+
+        // Wakes on a report, and now and then to notice children that died without one
+        pollfd ready{channel[0], POLLIN, 0};
+        poll(&ready, 1, 10);
+
+        // Reaped children have already written their reports, so drain the pipe after reaping.
+        // Only our own branches are waited on; other children of the process belong to someone else
+        for (auto child = children.begin(); child != children.end();)
+        {
+            int status;
+
+            if (waitpid(child->first, &status, WNOHANG) == child->first)
+                child = children.erase(child);
+            else
+                ++child;
+        }
+
+        BranchReport report;
+        while (read(channel[0], &report, sizeof(report)) == sizeof(report))
+        {
+            BranchResult &result = results[report.branch];
+            result.completed = true;
+            result.fitness = report.fitness;
+            std::memcpy(result.ram, report.ram, sizeof(result.ram));
+        }
+    }
+
+    close(channel[0]);
+    close(channel[1]);
+
+    return results;
+}
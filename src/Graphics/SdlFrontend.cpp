@@ -0,0 +1,136 @@
+#include <SdlFrontend.hpp>
+#include <NesSystem.hpp>
+#include <HwConstants.hpp>
+
+SdlFrontend::SdlFrontend(NesSystem &nes)
+    : nes{nes}, screen{new Display{DISPLAY::Width, DISPLAY::Height, nes.getFrameBuffer()}},
+      soundQueue{new Sound_Queue()}, fps{60}, delay{1000 / fps}, delayMultiplier{1.0}, rewindHeld{false}
+{
+    soundQueue->init(96000);
+    nes.setVideoSink(this);
+    nes.setAudioSink(this);
+}
+
+SdlFrontend::~SdlFrontend() noexcept
+{
+    nes.setVideoSink(nullptr);
+    nes.setAudioSink(nullptr);
+}
+
+// Run-ahead may hand over a frame drawn by another console
+void SdlFrontend::pushFrame(const uint32_t *frameBuffer)
+{
+    screen->frameBuffer = frameBuffer;
+    screen->blit(nes.getGameplayInput());
+}
+
+void SdlFrontend::pushSamples(const blip_sample_t *samples, size_t count)
+{
+    soundQueue->write(samples, count);
+}
+
+void SdlFrontend::processGameplayInput(const SDL_Event &event)
+{
+    uint8_t btn;
+
+    if (event.type != SDL_KEYDOWN && event.type != SDL_KEYUP)
+        return;
+
+    switch (event.key.keysym.sym)
+    {
+    case SDLK_BACKSPACE: // Rewind while held
+        rewindHeld = event.type == SDL_KEYDOWN;
+        return;
+    case SDLK_LEFT: // D-pad
+        btn = 0x02;
+        break;
+    case SDLK_RIGHT:
+        btn = 0x01;
+        break;
+    case SDLK_UP:
+        btn = 0x08;
+        break;
+    case SDLK_DOWN:
+        btn = 0x04;
+        break;
+    case SDLK_a: // A
+        btn = 0x80;
+        break;
+    case SDLK_s: // B
+        btn = 0x40;
+        break;
+    case SDLK_z: // Start
+        btn = 0x10;
+        break;
+    case SDLK_x: // Select
+        btn = 0x20;
+        break;
+    default:
+        return;
+    }
+
+    nes.processGameplayInput(btn, event.type == SDL_KEYDOWN);
+}
+
+bool SdlFrontend::run()
+{
+    frameStart = SDL_GetTicks();
+    if (nes.getState() != NesSystem::PLAY_TAS)
+    {
+        while (SDL_PollEvent(&e))
+        {
+            if (e.type != SDL_QUIT)
+            {
+                switch (nes.getState())
+                {
+                case NesSystem::PLAY:
+                    processGameplayInput(e);
+                    break;
+                case NesSystem::RECORD_TAS:
+                    // Enter records a frame; Backspace and Page Up go back a frame or a second to record it again
+                    do
+                    {
+                        if (e.type == SDL_QUIT)
+                        {
+                            return false;
+                        }
+                        if (e.type == SDL_KEYDOWN && (e.key.keysym.sym == SDLK_BACKSPACE || e.key.keysym.sym == SDLK_PAGEUP))
+                        {
+                            const uint32_t back = e.key.keysym.sym == SDLK_BACKSPACE ? 1 : fps;
+                            const uint32_t length = nes.getMovieLength();
+                            nes.seekMovie(length > back ? length - back : 0);
+                            return true;
+                        }
+                        processGameplayInput(e);
+                        SDL_PollEvent(&e);
+                    } while ((e.type != SDL_KEYDOWN || e.key.keysym.sym != SDLK_RETURN));
+                    nes.saveGameplayInput();
+                    break;
+                default:
+                    break;
+                }
+            }
+            else
+            {
+                return false;
+            }
+        }
+    }
+    else
+    {
+        SDL_PollEvent(&e);
+        if (!nes.loadGameplayInput())
+            return false;
+    }
+
+    if (rewindHeld)
+        nes.rewindFrame();
+    else
+        nes.runFrame();
+
+    frameTime = SDL_GetTicks() - frameStart;
+    if (frameTime < static_cast<uint32_t>(delay * delayMultiplier))
+        SDL_Delay((int)(delay - frameTime));
+
+    return true;
+}
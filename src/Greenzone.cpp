@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <cstring>
+
+#include <Greenzone.hpp>
+#include <StateDelta.hpp>
+
+Greenzone::Greenzone(size_t budget, uint32_t keyframeInterval)
+    : budget{budget}, bytes{0}, keyframeInterval{keyframeInterval ? keyframeInterval : 1}, oldestDelta{0},
+      base{new MachineState{}}, baseFrame{0}, baseValid{false}, scratch(MaxEncodedStateSize) {}
+
+void Greenzone::store(uint32_t frame, const MachineState &state)
+{
+    if (frame < frames.size())
+    {
+        truncate(frame);
+        drop(frame);
+    }
+    frames.resize(frame + 1);
+    oldestDelta = std::min(oldestDelta, frame);
+
+    Entry &entry = frames[frame];
+    entry.keyframe = !baseValid || frame - baseFrame >= keyframeInterval;
+
+    if (entry.keyframe)
+    {
+        entry.data.assign(scratch.begin(), scratch.begin() + encodeState(state, nullptr, scratch.data()));
+        std::memcpy(base.get(), &state, stateBytes(state));
+        baseFrame = frame;
+        baseValid = true;
+    }
+    else
+    {
+        entry.data.assign(scratch.begin(), scratch.begin() + encodeState(state, base.get(), scratch.data()));
+    }
+
+    bytes += entry.data.size();
+    thin();
+}
+
+uint32_t Greenzone::restore(uint32_t frame, MachineState &state)
+{
+    frame = std::min<uint32_t>(frame, frames.size() - 1);
+    while (frame > 0 && frames[frame].data.empty())
+        --frame;
+
+    const Entry &entry = frames[frame];
+    if (entry.keyframe)
+    {
+        decodeState(entry.data.data(), nullptr, state);
+    }
+    else
+    {
+        // Decoding a delta over its own keyframe works in place
+        decodeState(frames[keyframeBefore(frame)].data.data(), nullptr, state);
+        decodeState(entry.data.data(), &state, state);
+    }
+
+    return frame;
+}
+
+void Greenzone::truncate(uint32_t frame)
+{
+    for (size_t f = frame + 1; f < frames.size(); ++f)
+        drop(f);
+    if (frame + 1 < frames.size())
+        frames.resize(frame + 1);
+
+    oldestDelta = std::min<uint32_t>(oldestDelta, frames.size());
+}
+
+void Greenzone::drop(uint32_t frame)
+{
+    Entry &entry = frames[frame];
+
+    bytes -= entry.data.size();
+    std::vector<uint8_t>().swap(entry.data);
+
+    if (entry.keyframe && frame == baseFrame)
+        baseValid = false;
+    entry.keyframe = false;
+}
+
+void Greenzone::thin()
+{
+    // Oldest deltas first
+    for (; bytes > budget && oldestDelta < frames.size(); ++oldestDelta)
+    {
+        if (!frames[oldestDelta].keyframe)
+            drop(oldestDelta);
+    }
+
+    // No deltas are left, so halve the keyframes from the oldest, always keeping frame 0 and the newest
+    while (bytes > budget)
+    {
+        const uint32_t newest = keyframeBefore(frames.size() - 1);
+        bool odd = false, dropped = false;
+
+        for (uint32_t f = 1; f < newest && bytes > budget; ++f)
+        {
+            if (!frames[f].keyframe)
+                continue;
+            if (odd)
+            {
+                drop(f);
+                dropped = true;
+            }
+            odd = !odd;
+        }
+
+        if (!dropped)
+            break;
+    }
+}
+
+uint32_t Greenzone::keyframeBefore(uint32_t frame) const
+{
+    while (frame > 0 && !frames[frame].keyframe)
+        --frame;
+
+    return frame;
+}
+
+uint32_t Greenzone::size() const
+{
+    return frames.size();
+}
+
+bool Greenzone::has(uint32_t frame) const
+{
+    return frame < frames.size() && !frames[frame].data.empty();
+}
+
+size_t Greenzone::bytesUsed() const
+{
+    return bytes;
+}
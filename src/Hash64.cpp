@@ -0,0 +1,36 @@
+#include <cstring>
+
+#include <Hash64.hpp>
+
+static inline uint64_t mix(uint64_t h, uint64_t word)
+{
+    h ^= word * 0x9E3779B97F4A7C15;
+    h = (h << 27 | h >> 37) * 0xFF51AFD7ED558CCD;
+    return h;
+}
+
+uint64_t hash64(const void *data, size_t size, uint64_t seed)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    uint64_t h = seed ^ (size * 0xC2B2AE3D27D4EB4F);
+    uint64_t word;
+
+    for (; size >= sizeof(word); size -= sizeof(word), bytes += sizeof(word))
+    {
+        std::memcpy(&word, bytes, sizeof(word));
+        h = mix(h, word);
+    }
+
+    if (size > 0)
+    {
+        word = 0;
+        std::memcpy(&word, bytes, size);
+        h = mix(h, word);
+    }
+
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53;
+    h ^= h >> 33;
+
+    return h;
+}
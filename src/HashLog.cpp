@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+
+#include <HashLog.hpp>
+#include <Hash64.hpp>
+#include <NesSystem.hpp>
+#include <MachineState.hpp>
+
+const char *FrameHashes::name(Subsystem subsystem)
+{
+    static const char *const names[Count] = {"CPU", "RAM", "cartridge", "PPU", "APU", "frame buffer"};
+
+    return names[subsystem];
+}
+
+HashLog::HashLog(uint32_t romCrc) : header{HASHLOG_MAGIC, HASHLOG_VERSION, FrameHashes::Count, romCrc, 0} {}
+
+FrameHashes HashLog::hashFrame(NesSystem &nes)
+{
+    const MachineState &state = nes.captureState();
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&state);
+    FrameHashes hashes;
+
+    hashes.hash[FrameHashes::CPU] = hash64(bytes, offsetof(MachineState, ram));
+    hashes.hash[FrameHashes::RAM] = hash64(state.ram, sizeof(state.ram));
+    hashes.hash[FrameHashes::CART] = hash64(state.cartRam, state.cart.ramSize, hash64(&state.cart, sizeof(state.cart)));
+    hashes.hash[FrameHashes::PPU] = hash64(&state.ppu, sizeof(state.ppu));
+    hashes.hash[FrameHashes::APU] = hash64(&state.apu, sizeof(state.apu));
+    hashes.hash[FrameHashes::FRAMEBUFFER] =
+        hash64(nes.getFrameBuffer(), DISPLAY::Width * DISPLAY::Height * sizeof(uint32_t));
+
+    return hashes;
+}
+
+void HashLog::push(const FrameHashes &hashes)
+{
+    frames.push_back(hashes);
+    ++header.frameCount;
+}
+
+size_t HashLog::size() const
+{
+    return frames.size();
+}
+
+const FrameHashes &HashLog::operator[](size_t frame) const
+{
+    return frames[frame];
+}
+
+bool HashLog::save(const std::string &path)
+{
+    std::ofstream out(path, std::ofstream::binary);
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(frames.data()), frames.size() * sizeof(FrameHashes));
+
+    return out.good();
+}
+
+void HashLog::load(const std::string &path)
+{
+    std::ifstream in(path, std::ifstream::binary);
+    HashLogHeader loaded;
+
+    if (!in.read(reinterpret_cast<char *>(&loaded), sizeof(loaded)) || loaded.magic != HASHLOG_MAGIC)
+        throw std::invalid_argument("Not a hash log: " + path);
+    if (loaded.version != HASHLOG_VERSION || loaded.subsystems != FrameHashes::Count)
+        throw std::invalid_argument("Unsupported hash log version: " + path);
+
+    // The header's frame count is only trusted once the file is known to hold that many
+    const std::streampos body = in.tellg();
+    in.seekg(0, std::ifstream::end);
+    const uint64_t available = static_cast<uint64_t>(in.tellg() - body);
+    if (!in || available / sizeof(FrameHashes) < loaded.frameCount)
+        throw std::invalid_argument("Truncated hash log: " + path);
+    in.seekg(body);
+
+    std::vector<FrameHashes> hashes(loaded.frameCount);
+    if (!in.read(reinterpret_cast<char *>(hashes.data()), hashes.size() * sizeof(FrameHashes)))
+        throw std::invalid_argument("Truncated hash log: " + path);
+
+    frames.swap(hashes);
+    header = loaded;
+}
+
+uint32_t HashLog::getRomCrc() const
+{
+    return header.romCrc;
+}
+
+size_t HashLog::firstDivergence(const HashLog &reference) const
+{
+    const size_t common = std::min(frames.size(), reference.frames.size());
+
+    for (size_t frame = 0; frame < common; ++frame)
+    {
+        for (int i = 0; i < FrameHashes::Count; ++i)
+        {
+            if (frames[frame].hash[i] != reference.frames[frame].hash[i])
+                return frame;
+        }
+    }
+
+    return frames.size() == reference.frames.size() ? NoDivergence : common;
+}
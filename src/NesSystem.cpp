@@ -1,54 +1,60 @@
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <stdexcept>
 
 #include <NesSystem.hpp>
 #include <Ricoh2A03.hpp>
 #include <RicohRP2C02.hpp>
 #include <GamePak.hpp>
-#include <Display.hpp>
 #include <HwConstants.hpp>
 #include <Apu2A03.hpp>
 #include <GamePad.hpp>
+#include <StateArena.hpp>
+#include <RewindBuffer.hpp>
+#include <RunAheadWorker.hpp>
+#include <TasMovie.hpp>
+#include <Greenzone.hpp>
 
-NesSystem::NesSystem(EmuState state, std::string outputPath)
-    : systemClock{0}, p1Controller{new GamePad{}}, ppu{new RicohRP2C02{}}, cpu{new Ricoh2A03{ppu, p1Controller}},
-      screen{new Display{DISPLAY::Width, DISPLAY::Height, ppu->getFrameBuffData(), p1Controller}},
-      soundQueue{new Sound_Queue()}, dma_data{0x00}, dma_dummy{true}, fps{60}, delay{1000 / fps},
-      delayMultiplier{1.0}, state{state}, commandI{0}, scriptPath{outputPath}
+NesSystem::NesSystem(EmuState state, std::string outputPath, StateArena *arena)
+    : ownArena{arena ? nullptr : new StateArena{1}}, arena{arena ? arena : ownArena.get()}, machine{this->arena->allocate()},
+      p1Controller{new GamePad{machine->pad}}, ppu{new RicohRP2C02{machine->ppu}},
+      cpu{new Ricoh2A03{machine->cpu, machine->ram, ppu, p1Controller}}, cart{nullptr}, idleLoop{0},
+      videoSink{nullptr}, indexedSink{nullptr}, indexedOutput{false}, state{state}, scriptPath{outputPath},
+      rewindInterval{1}, runAheadFrames{0}, runAheadSynced{false}, runAheadInput{0}
 {
-    soundQueue->init(96000);
+    dma_dummy = true;
+    cpu->apu->apu.irq_notifier(&NesSystem::apuIrqChanged, this);
     if (state == PLAY_TAS)
     {
-        parseTasScript();
+        movieReader.reset(new TasReader{scriptPath});
     }
 }
 
 NesSystem::~NesSystem() noexcept
 {
-    if (state == RECORD_TAS)
+    arena->release(machine);
+
+    if (state == RECORD_TAS && cart)
     {
-        std::ofstream out;
+        TasWriter movie(cart->romCrc);
 
-        out.open(scriptPath, std::ofstream::binary);
-        for (size_t i = 0; i < commands.size(); ++i)
-        {
-            out << commands[i] << std::endl;
-        }
-        out.close();
+        for (uint8_t input : movieInput)
+            movie.push(&input);
+        if (!movie.save(scriptPath))
+            std::cerr << "Could not write the TAS movie to " << scriptPath << std::endl;
     }
 }
 
-void NesSystem::newSamples(const blip_sample_t *samples, size_t count)
-{
-    soundQueue->write(samples, count);
-}
-
 void NesSystem::tick()
 {
-    ppu->run();
+    ppu->deferUntil(systemClock + 1);
+    ppu->catchUp();
 
     if (systemClock % 3 == 0)
     {
+        lastCpuTick = systemClock;
         if (cpu->dma_transfer)
         {
             if (dma_dummy)
@@ -93,35 +99,212 @@ void NesSystem::tick()
     ++systemClock;
 }
 
-void NesSystem::reset()
+/*
+ * Advances the machine to the next point where something other than
+ * the PPU has to happen: the next instruction, or the earliest event.
+ * The CPU executes an instruction atomically on its first cycle, so the
+ * cycles in between only count down. The PPU is left behind and catches
+ * up whenever the CPU touches it, at vblank, and at the end of the frame.
+ * Produces exactly the same machine state as calling tick() once per dot.
+ */
+void NesSystem::step()
 {
-    cpu->reset();
-    ppu->reset();
-    systemClock = 0;
+    if (systemClock == 0 || scheduler.time(Scheduler::OAM_DMA) <= systemClock)
+    {
+        // DMA interleaves with the PPU on alternating cycles, so take it a dot at a time
+        scheduler.cancel(Scheduler::OAM_DMA);
+        do
+        {
+            tick();
+        } while (cpu->dma_transfer || systemClock % 3 != 0);
+        syncEvents();
+        return;
+    }
+
+    const uint64_t cpuTick = systemClock + (3 - systemClock % 3) % 3;
+    uint64_t target = cpuTick + 3 * static_cast<uint64_t>(cpu->cycles);
+
+    if (scheduler.nextTime() < target)
+        target = scheduler.nextTime();
+
+    // CPU cycles before the target are spent waiting on the current instruction
+    const uint32_t idle = cpuTick > target ? 0 : (target - cpuTick) / 3 + (target % 3 != 0);
+    cpu->cycles -= idle;
+    cpu->remaining -= idle;
+
+    systemClock = target + 1;
+    ppu->deferUntil(systemClock);
+
+    if (scheduler.time(Scheduler::APU_IRQ) <= target)
+    {
+        irqLine = true;
+        scheduler.cancel(Scheduler::APU_IRQ);
+    }
+
+    if (scheduler.time(Scheduler::MAPPER_IRQ) <= target)
+        scheduleMapperIrq();
+
+    if (target % 3 == 0)
+    {
+        --cpu->remaining;
+        lastCpuTick = target;
+
+        if (cpu->cycles == 0 && irqLine)
+        {
+            irqLine = cpu->apu->apu.earliest_irq() <= cpu->elapsed() || cart->irqAsserted();
+            if (irqLine && !cpu->getFlag(Ricoh2A03::I))
+                cpu->irq();
+        }
+
+        // A pending IRQ is no reason to stay if I is set, since the loop never clears it
+        if (idleLoop && cpu->PC == idleLoop && cpu->cycles == 0 && (!irqLine || cpu->getFlag(Ricoh2A03::I)) && !ppu->requestCpuNmi)
+            target = skipIdleLoop(target);
+
+        cpu->fetch();
+
+        if (cpu->dma_transfer)
+            scheduler.schedule(Scheduler::OAM_DMA, target + 1);
+    }
+    else
+    {
+        lastCpuTick = target - target % 3;
+    }
+
+    if (scheduler.time(Scheduler::VBLANK) == target)
+    {
+        ppu->catchUp();
+        scheduler.schedule(Scheduler::VBLANK, target + FRAME_DOTS);
+    }
+
+    if (ppu->requestCpuNmi)
+    {
+        cpu->nmi();
+        ppu->requestCpuNmi = false;
+    }
+}
+
+/*
+ * A game spinning on a JMP to itself changes nothing but the clock until
+ * an event interrupts it, so every pass that ends before the next event is
+ * run at once. The CPU lands on the same instruction boundary, with the
+ * same cycle count, as it would have one pass at a time.
+ */
+uint64_t NesSystem::skipIdleLoop(uint64_t tick)
+{
+    const uint64_t next = scheduler.nextTime();
+
+    // The database only names the loop, so check it is still the one in the current bank
+    if (next <= tick + IDLE_LOOP_DOTS || cpu->read(idleLoop) != 0x4C || cpu->readDoubleWord(idleLoop + 1) != idleLoop)
+        return tick;
+
+    const uint64_t passes = (next - tick - 1) / IDLE_LOOP_DOTS;
+    tick += passes * IDLE_LOOP_DOTS;
+    cpu->remaining -= 3 * passes;
+
+    lastCpuTick = tick;
+    systemClock = tick + 1;
+    ppu->deferUntil(systemClock);
+
+    return tick;
+}
+
+void NesSystem::syncEvents()
+{
+    scheduler.schedule(Scheduler::VBLANK, systemClock + ppu->dotsUntil(VBLANK_SCANLINE, 1) - 1);
+    scheduler.schedule(Scheduler::FRAME_END, lastCpuTick + 3 * static_cast<uint64_t>(std::max(cpu->remaining, 0)));
+    scheduleApuIrq();
+    scheduleMapperIrq();
+}
+
+// APU timestamps count CPU cycles since the start of the frame
+void NesSystem::scheduleApuIrq()
+{
+    const cpu_time_t irqTime = cpu->apu->apu.earliest_irq();
+
+    if (irqTime == Nes_Apu::no_irq)
+    {
+        scheduler.cancel(Scheduler::APU_IRQ);
+    }
+    else
+    {
+        const cpu_time_t wait = std::max<cpu_time_t>(irqTime - cpu->elapsed(), 1);
+        scheduler.schedule(Scheduler::APU_IRQ, lastCpuTick + 3 * wait);
+    }
+}
+
+void NesSystem::apuIrqChanged(void *nes)
+{
+    static_cast<NesSystem *>(nes)->scheduleApuIrq();
 }
 
-void NesSystem::parseTasScript()
+/*
+ * The PPU clocks the cartridge's scanline counter as it renders, but it
+ * runs behind, so the IRQ is predicted from the counter and the PPU's
+ * position and raised by an event. The prediction is redone whenever the
+ * counter or the PPU's A12 timing changes, and at the event itself, which
+ * for a distant IRQ is only a checkpoint on the way.
+ */
+void NesSystem::scheduleMapperIrq()
 {
-    std::ifstream in;
-    uint8_t frameInput;
+    if (!cart->scanlineCounter)
+        return;
 
-    in.open(scriptPath, std::ifstream::binary);
-    while (!in.eof())
+    ppu->catchUp();
+    if (cart->irqAsserted())
     {
-        in >> frameInput;
-        commands.emplace_back(frameInput);
+        irqLine = true;
+        scheduler.cancel(Scheduler::MAPPER_IRQ);
+        return;
     }
-    in.close();
+
+    const uint32_t dots = ppu->dotsUntilScanlineClock(cart->scanlinesUntilIrq());
+    if (dots == 0)
+        scheduler.cancel(Scheduler::MAPPER_IRQ);
+    else
+        scheduler.schedule(Scheduler::MAPPER_IRQ, ppu->getClock() + dots - 1);
+}
+
+void NesSystem::mapperIrqChanged(void *nes)
+{
+    static_cast<NesSystem *>(nes)->scheduleMapperIrq();
+}
+
+void NesSystem::reset()
+{
+    cpu->reset();
+    ppu->reset();
+    systemClock = 0;
+    lastCpuTick = 0;
+    irqLine = false;
+    scheduler.clear();
+    runAheadSynced = false;
 }
 
 // #define DISASSEMBLE
 void NesSystem::insertCartridge(const std::string &romName)
 {
-    std::shared_ptr<AddressableDevice> cart(new GamePak(romName));
+    this->romName = romName;
+    cart = new GamePak(romName, machine->cart, machine->cartRam);
+    std::shared_ptr<AddressableDevice> device(cart);
 
-    cpu->addCartridge(cart);
-    ppu->addCartridge(cart);
+    cart->irqNotify(&NesSystem::mapperIrqChanged, this);
+    // Fast paths the ROM database vouches for
+    ppu->setScanlineRenderer(!cart->info || !(cart->info->hints & RomInfo::DOT_RENDERER));
+    idleLoop = cart->info ? cart->info->idleLoop : 0;
+    cpu->addCartridge(device);
+    ppu->addCartridge(device);
     reset();
+
+    if (movieReader)
+    {
+        const TasHeader &movie = movieReader->getHeader();
+        const uint8_t *startState = movieReader->getStartState();
+
+        if (movie.romCrc != cart->romCrc)
+            throw std::invalid_argument("The TAS movie was recorded on a different ROM");
+        if (startState && !loadState(std::vector<uint8_t>(startState, startState + movie.stateSize)))
+            throw std::invalid_argument("The TAS movie starts from a save state this build cannot load");
+    }
 #ifdef DISASSEMBLE
     uint16_t PC = CPU::CARTRIDGE::Base;
     int8_t nameEnd = romName.size() - 1;
@@ -148,9 +331,65 @@ void NesSystem::insertCartridge(const std::string &romName)
 #endif
 }
 
-void NesSystem::processGameplayInput(const SDL_Event &event)
+uint64_t NesSystem::getFrameCount() const
 {
-    p1Controller->registerInputStateChange(event);
+    return frameCount;
+}
+
+NesSystem::EmuState NesSystem::getState() const
+{
+    return state;
+}
+
+uint32_t NesSystem::getRomCrc() const
+{
+    return cart->romCrc;
+}
+
+const uint32_t *NesSystem::getFrameBuffer() const
+{
+    return ppu->getFrameBuffData();
+}
+
+void NesSystem::setVideoSink(VideoSink *sink)
+{
+    videoSink = sink;
+}
+
+void NesSystem::setIndexedOutput(bool enabled)
+{
+    indexedOutput = enabled;
+    ppu->setIndexedOutput(enabled);
+}
+
+bool NesSystem::getIndexedOutput() const
+{
+    return indexedOutput;
+}
+
+void NesSystem::setIndexedVideoSink(IndexedVideoSink *sink)
+{
+    indexedSink = sink;
+}
+
+const uint8_t *NesSystem::getIndexBuffer() const
+{
+    return ppu->getIndexBuffData();
+}
+
+const uint32_t *NesSystem::getPalette() const
+{
+    return ppu->getPalette();
+}
+
+void NesSystem::setAudioSink(AudioSink *sink)
+{
+    cpu->apu->sink = sink;
+}
+
+void NesSystem::processGameplayInput(const uint8_t btn, const bool pressed)
+{
+    p1Controller->registerInputStateChange(btn, pressed);
 }
 
 void NesSystem::setGameplayInput(const uint8_t btns)
@@ -158,71 +397,304 @@ void NesSystem::setGameplayInput(const uint8_t btns)
     p1Controller->setPressRegister(btns);
 }
 
-void NesSystem::saveGameplayInput()
+uint8_t NesSystem::getGameplayInput() const
 {
-    commands.emplace_back(p1Controller->readPressReg());
+    return p1Controller->readPressReg();
 }
 
-void NesSystem::outputFrame() const
+// Applies the next frame of a loaded TAS movie, false once it runs out
+bool NesSystem::loadGameplayInput()
 {
-    cpu->processFrameAudio();
-    screen->blit();
+    uint8_t inputs[TAS_MAX_CONTROLLERS];
+
+    if (!movieReader || !movieReader->next(inputs))
+        return false;
+
+    setGameplayInput(inputs[0]);
+    return true;
+}
+
+// Records the buttons held for the next frame, keeping the state before it in the greenzone
+void NesSystem::saveGameplayInput()
+{
+    if (greenzone)
+        greenzone->store(movieInput.size(), captureState());
+    movieInput.push_back(p1Controller->readPressReg());
 }
 
-bool NesSystem::run()
+void NesSystem::outputFrame() const
 {
-    frameStart = SDL_GetTicks();
-    if (state != PLAY_TAS)
+    cpu->processFrameAudio();
+    if (indexedOutput)
     {
-        while (SDL_PollEvent(&e))
-        {
-            if (e.type != SDL_QUIT)
-            {
-                switch (state)
-                {
-                case PLAY:
-                    processGameplayInput(e);
-                    break;
-                case RECORD_TAS:
-                    do
-                    {
-                        if (e.type == SDL_QUIT)
-                        {
-                            return false;
-                        }
-                        processGameplayInput(e);
-                        SDL_PollEvent(&e);
-                    } while ((e.type != SDL_KEYDOWN || e.key.keysym.sym != SDLK_RETURN));
-                    saveGameplayInput();
-                    break;
-                default:
-                    break;
-                }
-            }
-            else
-            {
-                return false;
-            }
-        }
+        if (indexedSink)
+            indexedSink->pushFrame(ppu->getIndexBuffData());
     }
-    else if (state == PLAY_TAS && commandI < commands.size())
+    else if (videoSink)
     {
-        SDL_PollEvent(&e);
-        setGameplayInput(commands[commandI++]);
+        videoSink->pushFrame(ppu->getFrameBuffData());
     }
+}
+
+void NesSystem::runFrame()
+{
+    if (runAheadFrames == 0)
+        emulateFrame(VIDEO | AUDIO | RECORD);
+    else if (runAheadWorker)
+        runAheadThreaded();
     else
+        runAhead();
+}
+
+void NesSystem::skipFrame()
+{
+    emulateFrame(0);
+}
+
+void NesSystem::emulateFrame(uint8_t output)
+{
+    // Taken before the frame, so the state holds the buttons the frame is played with and a rewind can replay it
+    if ((output & RECORD) && rewindBuffer && frameCount % rewindInterval == 0)
+        rewindBuffer->push(captureState());
+
+    VideoSink *const sink = videoSink;
+    IndexedVideoSink *const indexed = indexedSink;
+
+    if (!(output & VIDEO))
     {
-        return false;
+        videoSink = nullptr;
+        indexedSink = nullptr;
     }
+    if (!(output & AUDIO))
+        cpu->apu->setMuted(true);
 
     cpu->restartFrameTimer();
+    if (systemClock > 0)
+        scheduler.schedule(Scheduler::FRAME_END, lastCpuTick + 3 * static_cast<uint64_t>(cpu->remaining));
     while (!cpu->isFrameDone())
-        tick();
+        step();
+    ppu->catchUp();
     outputFrame();
+    ++frameCount;
+
+    videoSink = sink;
+    indexedSink = indexed;
+    if (!(output & AUDIO))
+        cpu->apu->setMuted(false);
+}
+
+size_t NesSystem::stateSize() const
+{
+    return sizeof(SaveStateHeader) + stateBytes(*machine);
+}
+
+/*
+ * Snapshots the whole machine. States are meant to be taken between
+ * frames, where the APU snapshot is exact.
+ */
+void NesSystem::saveState(std::vector<uint8_t> &out)
+{
+    const SaveStateHeader header{SAVESTATE_MAGIC, SAVESTATE_VERSION, static_cast<uint32_t>(stateSize()), cart->romCrc};
+
+    out.resize(stateSize());
+    std::memcpy(out.data(), &header, sizeof(header));
+    std::memcpy(out.data() + sizeof(header), &captureState(), stateBytes(*machine));
+}
+
+// Leaves the machine untouched and returns false if the state is not from this build and ROM
+bool NesSystem::loadState(const std::vector<uint8_t> &state)
+{
+    SaveStateHeader header;
+
+    if (state.size() != stateSize())
+        return false;
+
+    std::memcpy(&header, state.data(), sizeof(header));
+    if (header.magic != SAVESTATE_MAGIC || header.version != SAVESTATE_VERSION || header.size != stateSize())
+        return false;
+    if (header.romCrc != cart->romCrc)
+        return false;
+
+    restoreState(*reinterpret_cast<const MachineState *>(state.data() + sizeof(header)));
+
+    return true;
+}
+
+// Makes this console a clone of another running the same cartridge
+void NesSystem::copyStateFrom(NesSystem &other)
+{
+    restoreState(other.captureState());
+}
+
+// The state block, brought up to date with the PPU and APU
+const MachineState &NesSystem::captureState()
+{
+    ppu->catchUp();
+    cpu->apu->apu.save_snapshot(&machine->apu);
+    machine->apuFrameIrq = cpu->apu->apu.next_frame_irq();
+
+    return *machine;
+}
+
+void NesSystem::restoreState(const MachineState &state)
+{
+    std::memcpy(machine, &state, stateBytes(state));
+    stateLoaded();
+}
+
+void NesSystem::stateLoaded()
+{
+    const Scheduler events = scheduler;
+
+    // Restoring the APU reschedules its IRQ from a stale clock; the copied events are already right
+    cpu->apu->apu.load_snapshot(machine->apu);
+    cpu->apu->apu.set_next_frame_irq(machine->apuFrameIrq);
+    scheduler = events;
+
+    cart->stateLoaded();
+    ppu->stateLoaded();
+    cpu->bus->remap();
+    runAheadSynced = false;
+}
+
+// Records the state every interval frames, keeping as many as fit in capacity bytes
+void NesSystem::enableRewind(size_t capacity, uint32_t interval)
+{
+    rewindInterval = interval ? interval : 1;
+    rewindBuffer.reset(new RewindBuffer(capacity));
+}
+
+/*
+ * Steps back to the newest recorded frame before the one on screen and
+ * shows it. The frame buffer is not state, so the frame is redrawn by
+ * emulating it again from the state before it, with the buttons it was
+ * played with and the audio muted. The buttons held now are kept for the
+ * frames that follow. Returns false once there is nothing older to go
+ * back to.
+ */
+bool NesSystem::rewindFrame()
+{
+    const uint64_t shown = frameCount;
+    const uint8_t held = getGameplayInput();
+    bool popped = false;
+
+    if (!rewindBuffer)
+        return false;
+
+    while (frameCount + 2 > shown && rewindBuffer->pop(*machine))
+        popped = true;
 
-    frameTime = SDL_GetTicks() - frameStart;
-    if (frameTime < static_cast<uint32_t>(delay * delayMultiplier))
-        SDL_Delay((int)(delay - frameTime));
+    if (!popped)
+        return false;
+
+    stateLoaded();
+    const bool replayed = frameCount + 2 <= shown;
+    if (replayed)
+        emulateFrame(VIDEO);
+    setGameplayInput(held);
+
+    return replayed;
+}
+
+const RewindBuffer *NesSystem::getRewindBuffer() const
+{
+    return rewindBuffer.get();
+}
+
+/*
+ * Shows the frame the given number of frames ahead of the real one,
+ * as it would look if the input stayed as it is, so the reaction to a
+ * press appears that many frames sooner. With a second instance the
+ * speculative frames run on another thread alongside the real one.
+ */
+void NesSystem::enableRunAhead(uint32_t frames, bool secondInstance)
+{
+    runAheadFrames = frames;
+    runAheadSynced = false;
+    runAheadState.reset(frames ? new MachineState{} : nullptr);
+    runAheadWorker.reset(frames && secondInstance ? new RunAheadWorker{romName} : nullptr);
+}
+
+// Only the real frame is heard and only the last speculative one is seen
+void NesSystem::runAhead()
+{
+    emulateFrame(AUDIO | RECORD);
+    std::memcpy(runAheadState.get(), &captureState(), stateBytes(*machine));
+
+    for (uint32_t i = 1; i < runAheadFrames; ++i)
+        emulateFrame(0);
+    emulateFrame(VIDEO);
+
+    restoreState(*runAheadState);
+}
+
+/*
+ * The second instance starts from the state before the real frame and
+ * plays it and the frames after it with the same input. While the input
+ * holds it is already that far ahead and needs only one more frame.
+ */
+void NesSystem::runAheadThreaded()
+{
+    const uint8_t input = getGameplayInput();
+
+    if (runAheadSynced && input == runAheadInput)
+    {
+        runAheadWorker->start(input, 1);
+    }
+    else
+    {
+        runAheadWorker->resync(*this);
+        runAheadWorker->start(input, runAheadFrames + 1);
+    }
+
+    emulateFrame(AUDIO | RECORD);
+
+    const uint32_t *const frameBuffer = runAheadWorker->finish();
+    if (videoSink)
+        videoSink->pushFrame(frameBuffer);
+
+    runAheadSynced = true;
+    runAheadInput = input;
+}
+
+void NesSystem::enableGreenzone(size_t budget)
+{
+    greenzone.reset(new Greenzone(budget));
+}
+
+uint32_t NesSystem::getMovieLength() const
+{
+    return movieInput.size();
+}
+
+/*
+ * Goes back to just before the given frame of the movie being recorded
+ * and forgets the input from there on, so recording picks up at that
+ * frame. The nearest greenzone state is restored and the recorded input
+ * replayed up to the frame, showing the last one. False if the frame
+ * is past the end of the movie.
+ */
+bool NesSystem::seekMovie(uint32_t frame)
+{
+    if (!greenzone || frame > movieInput.size() || greenzone->size() == 0)
+        return false;
+
+    uint32_t at = greenzone->restore(frame ? frame - 1 : 0, *machine);
+    stateLoaded();
+
+    for (; at < frame; ++at)
+    {
+        setGameplayInput(movieInput[at]);
+        emulateFrame(at + 1 == frame ? VIDEO : 0);
+    }
+
+    movieInput.resize(frame);
+    greenzone->truncate(frame);
 
     return true;
 }
+
+const Greenzone *NesSystem::getGreenzone() const
+{
+    return greenzone.get();
+}
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include <ObservationFilter.hpp>
+#include <HwConstants.hpp>
+
+ObservationFilter::ObservationFilter(const uint32_t *palette, uint16_t width, uint16_t height, bool maxPool)
+    : width{width}, height{height}, maxPool{maxPool}, columns(width + 1), rows(height + 1), sums(width), latest{0},
+      pooled(width * height)
+{
+    if (width == 0 || height == 0 || width > DISPLAY::Width || height > DISPLAY::Height)
+        throw std::invalid_argument("Observations must be between 1x1 and 256x240");
+
+    // ITU-R BT.601 weights
+    for (uint8_t i = 0; i < 0x40; ++i)
+    {
+        const uint32_t colour = palette[i];
+        luma[i] = (299 * ((colour >> 16) & 0xFF) + 587 * ((colour >> 8) & 0xFF) + 114 * (colour & 0xFF)) / 1000;
+    }
+
+    for (uint16_t x = 0; x <= width; ++x)
+        columns[x] = x * DISPLAY::Width / width;
+    for (uint16_t y = 0; y <= height; ++y)
+        rows[y] = y * DISPLAY::Height / height;
+
+    frames[0].resize(width * height);
+    frames[1].resize(width * height);
+}
+
+void ObservationFilter::pushFrame(const uint8_t *indices)
+{
+    latest ^= 1;
+    uint8_t *out = frames[latest].data();
+
+    for (uint16_t y = 0; y < height; ++y)
+    {
+        std::fill(sums.begin(), sums.end(), 0);
+
+        for (uint16_t row = rows[y]; row < rows[y + 1]; ++row)
+        {
+            const uint8_t *line = indices + row * DISPLAY::Width;
+
+            for (uint16_t x = 0; x < width; ++x)
+            {
+                for (uint16_t column = columns[x]; column < columns[x + 1]; ++column)
+                    sums[x] += luma[line[column] & 0x3F];
+            }
+        }
+
+        const uint32_t boxHeight = rows[y + 1] - rows[y];
+        for (uint16_t x = 0; x < width; ++x)
+            *out++ = sums[x] / (boxHeight * (columns[x + 1] - columns[x]));
+    }
+
+    if (maxPool)
+    {
+        const uint8_t *a = frames[0].data();
+        const uint8_t *b = frames[1].data();
+
+        // A flat byte loop the compiler turns into packed maximums
+        for (size_t i = 0; i < pooled.size(); ++i)
+            pooled[i] = std::max(a[i], b[i]);
+    }
+}
+
+void ObservationFilter::reset()
+{
+    std::fill(frames[0].begin(), frames[0].end(), 0);
+    std::fill(frames[1].begin(), frames[1].end(), 0);
+    std::fill(pooled.begin(), pooled.end(), 0);
+}
+
+const uint8_t *ObservationFilter::getFrame() const
+{
+    return maxPool ? pooled.data() : frames[latest].data();
+}
+
+size_t ObservationFilter::size() const
+{
+    return pooled.size();
+}
@@ -1,6 +1,6 @@
 #include <PaletteRam.hpp>
 
-PaletteRam::PaletteRam(const uint16_t size) : Ram::Ram{size} {}
+PaletteRam::PaletteRam(uint8_t *contents) : Ram::Ram{contents} {}
 
 inline uint16_t PaletteRam::mirrorAddress(uint16_t addr, uint16_t mirror)
 {
@@ -10,4 +10,14 @@ inline uint16_t PaletteRam::mirrorAddress(uint16_t addr, uint16_t mirror)
         addr &= 0x000F;
 
     return addr;
+}
+
+uint8_t *PaletteRam::getPage(uint16_t addr, uint16_t mirror, bool write)
+{
+    (void)addr;
+    (void)mirror;
+    (void)write;
+
+    // Backdrop colour mirroring is finer than a page
+    return nullptr;
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include <Vram.hpp>
 
-VRam::VRam(const uint16_t size, GamePak::MirrorMode mMode) 
-    : Ram::Ram{size}, mMode{mMode} {}
+VRam::VRam(uint8_t *contents, GamePak::MirrorMode mMode) 
+    : Ram::Ram{contents}, mMode{mMode} {}
 
 inline uint16_t VRam::mirrorAddress(uint16_t addr, uint16_t mirror)
 {
@@ -18,5 +18,5 @@ inline uint16_t VRam::mirrorAddress(uint16_t addr, uint16_t mirror)
         base = 0x0400;
     }
 
-    return base + addr & 0x03FF;
+    return base + (addr & 0x03FF);
 }
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include <RamExpression.hpp>
+#include <HwConstants.hpp>
+
+RamExpression::RamExpression(const std::string &source) : depth{0}, source{source}, pos{0}
+{
+    binary(0);
+    skipSpaces();
+    if (pos != source.size())
+        throw std::invalid_argument("Unexpected '" + source.substr(pos, 1) + "' at column " + std::to_string(pos + 1) + " of " + source);
+
+    // The deepest the evaluation stack can get
+    size_t height = 0;
+    for (const Instruction &instruction : program)
+    {
+        if (instruction.op == CONSTANT || instruction.op == LOAD)
+            depth = std::max(depth, ++height);
+        else if (instruction.op != NEGATE)
+            --height;
+    }
+
+    if (depth > RAMEXPR_MAX_DEPTH)
+        throw std::invalid_argument("Expression nests too deeply: " + source);
+}
+
+void RamExpression::skipSpaces()
+{
+    while (pos < source.size() && std::isspace(static_cast<unsigned char>(source[pos])))
+        ++pos;
+}
+
+bool RamExpression::accept(const char *token)
+{
+    const size_t length = std::strlen(token);
+
+    skipSpaces();
+    if (source.compare(pos, length, token) != 0)
+        return false;
+    pos += length;
+    return true;
+}
+
+// Precedence climbing over the binary operators, from loosest to tightest binding
+void RamExpression::binary(int level)
+{
+    static const struct
+    {
+        const char *tokens[4];
+        Op ops[4];
+    } levels[] = {
+        {{"|"}, {OR}},
+        {{"^"}, {XOR}},
+        {{"&"}, {AND}},
+        {{"==", "!="}, {EQUAL, NOT_EQUAL}},
+        {{"<=", ">=", "<", ">"}, {LESS_EQUAL, GREATER_EQUAL, LESS, GREATER}},
+        {{"<<", ">>"}, {SHIFT_LEFT, SHIFT_RIGHT}},
+        {{"+", "-"}, {ADD, SUBTRACT}},
+        {{"*", "/", "%"}, {MULTIPLY, DIVIDE, MODULO}},
+    };
+
+    if (level == sizeof(levels) / sizeof(levels[0]))
+    {
+        unary();
+        return;
+    }
+
+    binary(level + 1);
+
+    bool matched = true;
+    while (matched)
+    {
+        matched = false;
+        for (int i = 0; i < 4 && levels[level].tokens[i]; ++i)
+        {
+            if (accept(levels[level].tokens[i]))
+            {
+                binary(level + 1);
+                emit(levels[level].ops[i]);
+                matched = true;
+                break;
+            }
+        }
+    }
+}
+
+void RamExpression::unary()
+{
+    skipSpaces();
+
+    if (accept("-"))
+    {
+        unary();
+        emit(NEGATE);
+    }
+    else if (accept("("))
+    {
+        binary(0);
+        if (!accept(")"))
+            throw std::invalid_argument("Missing ')' at column " + std::to_string(pos + 1) + " of " + source);
+    }
+    else
+    {
+        const bool address = accept("$");
+        const char *start = source.c_str() + pos;
+        const bool hex = address || (start[0] == '0' && (start[1] == 'x' || start[1] == 'X'));
+        char *end = const_cast<char *>(start);
+        int64_t value = 0;
+
+        // strtoll would also take a sign or leading spaces, which belong to the expression
+        if (std::isxdigit(static_cast<unsigned char>(start[0])))
+            value = std::strtoll(start, &end, hex ? 16 : 10);
+
+        if (end == start)
+            throw std::invalid_argument("Expected a number or $address at column " + std::to_string(pos + 1) + " of " + source);
+
+        pos += end - start;
+        if (address)
+            emit(LOAD, value & (CPU::RAM::Size - 1));
+        else
+            emit(CONSTANT, value);
+    }
+}
+
+void RamExpression::emit(Op op, int64_t value)
+{
+    program.push_back(Instruction{op, value});
+}
+
+int64_t RamExpression::evaluate(const uint8_t *ram) const
+{
+    int64_t stack[RAMEXPR_MAX_DEPTH];
+    size_t top = 0;
+
+    for (const Instruction &instruction : program)
+    {
+        if (instruction.op == CONSTANT)
+        {
+            stack[top++] = instruction.value;
+            continue;
+        }
+        if (instruction.op == LOAD)
+        {
+            stack[top++] = ram[instruction.value];
+            continue;
+        }
+
+        const int64_t rhs = instruction.op == NEGATE ? 0 : stack[--top];
+        int64_t &lhs = stack[top - 1];
+
+        switch (instruction.op)
+        {
+        case NEGATE:
+            lhs = -lhs;
+            break;
+        case ADD:
+            lhs += rhs;
+            break;
+        case SUBTRACT:
+            lhs -= rhs;
+            break;
+        case MULTIPLY:
+            lhs *= rhs;
+            break;
+        case DIVIDE:
+            lhs = rhs ? lhs / rhs : 0;
+            break;
+        case MODULO:
+            lhs = rhs ? lhs % rhs : 0;
+            break;
+        case AND:
+            lhs &= rhs;
+            break;
+        case OR:
+            lhs |= rhs;
+            break;
+        case XOR:
+            lhs ^= rhs;
+            break;
+        case EQUAL:
+            lhs = lhs == rhs;
+            break;
+        case NOT_EQUAL:
+            lhs = lhs != rhs;
+            break;
+        case LESS:
+            lhs = lhs < rhs;
+            break;
+        case LESS_EQUAL:
+            lhs = lhs <= rhs;
+            break;
+        case GREATER:
+            lhs = lhs > rhs;
+            break;
+        case GREATER_EQUAL:
+            lhs = lhs >= rhs;
+            break;
+        case SHIFT_LEFT:
+            lhs <<= rhs & 63;
+            break;
+        case SHIFT_RIGHT:
+            lhs >>= rhs & 63;
+            break;
+        default:
+            break;
+        }
+    }
+
+    return stack[0];
+}
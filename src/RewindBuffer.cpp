@@ -0,0 +1,140 @@
+#include <cstring>
+
+#include <RewindBuffer.hpp>
+#include <StateDelta.hpp>
+
+RewindBuffer::RewindBuffer(size_t capacity, uint32_t keyframeInterval)
+    : ring(capacity > 2 * MaxEncodedStateSize ? capacity : 2 * MaxEncodedStateSize), head{0}, nextSequence{0},
+      keyframeInterval{keyframeInterval ? keyframeInterval : 1}, sinceKeyframe{0},
+      base{new MachineState{}}, baseSequence{0}, baseValid{false}, scratch(MaxEncodedStateSize), pendingKeyframe{false} {}
+
+void RewindBuffer::push(const MachineState &state)
+{
+    encode(state, !baseValid || sinceKeyframe >= keyframeInterval);
+    store(state);
+    ++sinceKeyframe;
+}
+
+// Encodes state into scratch, as a new keyframe or as a delta against base
+void RewindBuffer::encode(const MachineState &state, bool keyframe)
+{
+    scratch.resize(MaxEncodedStateSize);
+
+    if (keyframe)
+    {
+        scratch.resize(encodeState(state, nullptr, scratch.data()));
+        std::memcpy(base.get(), &state, stateBytes(state));
+        baseSequence = nextSequence;
+        baseValid = true;
+        sinceKeyframe = 0;
+    }
+    else
+    {
+        scratch.resize(encodeState(state, base.get(), scratch.data()));
+    }
+
+    pendingKeyframe = keyframe;
+}
+
+// Copies scratch in at the head, evicting whatever it runs over
+void RewindBuffer::store(const MachineState &state)
+{
+    const auto evict = [this]() {
+        if (entries.front().sequence == baseSequence)
+            baseValid = false;
+        entries.pop_front();
+    };
+
+    for (;;)
+    {
+        const size_t size = scratch.size();
+
+        // Whatever lies past the head is the oldest data, so leave the tail unused and start over
+        if (head + size > ring.size())
+        {
+            while (!entries.empty() && entries.front().offset >= head)
+                evict();
+            head = 0;
+        }
+
+        while (!entries.empty() && entries.front().offset < head + size && head < entries.front().offset + entries.front().size)
+            evict();
+
+        // Deltas are useless without their keyframe
+        while (!entries.empty() && !entries.front().keyframe)
+            evict();
+
+        // A delta whose keyframe was just evicted has to become a keyframe itself, which may need more room
+        if (pendingKeyframe || baseValid)
+            break;
+        encode(state, true);
+    }
+
+    std::memcpy(ring.data() + head, scratch.data(), scratch.size());
+    entries.push_back(Entry{head, scratch.size(), nextSequence++, pendingKeyframe});
+    head += scratch.size();
+}
+
+bool RewindBuffer::pop(MachineState &state)
+{
+    if (entries.empty())
+        return false;
+
+    const Entry entry = entries.back();
+    entries.pop_back();
+
+    if (entry.keyframe)
+    {
+        decodeState(ring.data() + entry.offset, nullptr, state);
+    }
+    else
+    {
+        // The keyframe is the newest one left, and is usually still decoded in base
+        size_t k = entries.size();
+        while (!entries[k - 1].keyframe)
+            --k;
+        const Entry &key = entries[k - 1];
+
+        if (!baseValid || baseSequence != key.sequence)
+        {
+            decodeState(ring.data() + key.offset, nullptr, *base);
+            baseSequence = key.sequence;
+            baseValid = true;
+        }
+
+        decodeState(ring.data() + entry.offset, base.get(), state);
+    }
+
+    // New states must not be taken against a keyframe that is gone or older than the head
+    sinceKeyframe = keyframeInterval;
+    head = entries.empty() ? 0 : entries.back().offset + entries.back().size;
+
+    return true;
+}
+
+void RewindBuffer::clear()
+{
+    entries.clear();
+    head = 0;
+    baseValid = false;
+}
+
+size_t RewindBuffer::size() const
+{
+    return entries.size();
+}
+
+size_t RewindBuffer::bytesUsed() const
+{
+    size_t used = 0;
+
+    for (const Entry &entry : entries)
+        used += entry.size;
+
+    return used;
+}
+
+size_t RewindBuffer::capacity() const
+{
+    return ring.size();
+}
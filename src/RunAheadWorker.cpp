@@ -0,0 +1,65 @@
+#include <RunAheadWorker.hpp>
+#include <NesSystem.hpp>
+
+RunAheadWorker::RunAheadWorker(const std::string &romName)
+    : nes{new NesSystem{NesSystem::PLAY}}, pendingFrames{0}, pendingInput{0}, quit{false}
+{
+    nes->insertCartridge(romName);
+    thread = std::thread{&RunAheadWorker::work, this};
+}
+
+RunAheadWorker::~RunAheadWorker() noexcept
+{
+    {
+        std::lock_guard<std::mutex> guard{lock};
+        quit = true;
+    }
+    wake.notify_all();
+    thread.join();
+}
+
+void RunAheadWorker::work()
+{
+    std::unique_lock<std::mutex> guard{lock};
+
+    while (true)
+    {
+        wake.wait(guard, [this] { return quit || pendingFrames > 0; });
+        if (quit)
+            return;
+
+        const uint32_t frames = pendingFrames;
+        nes->setGameplayInput(pendingInput);
+        guard.unlock();
+
+        for (uint32_t i = 0; i < frames; ++i)
+            nes->runFrame();
+
+        guard.lock();
+        pendingFrames = 0;
+        wake.notify_all();
+    }
+}
+
+void RunAheadWorker::resync(NesSystem &source)
+{
+    nes->copyStateFrom(source);
+}
+
+void RunAheadWorker::start(uint8_t input, uint32_t frames)
+{
+    {
+        std::lock_guard<std::mutex> guard{lock};
+        pendingInput = input;
+        pendingFrames = frames;
+    }
+    wake.notify_all();
+}
+
+const uint32_t *RunAheadWorker::finish()
+{
+    std::unique_lock<std::mutex> guard{lock};
+    wake.wait(guard, [this] { return pendingFrames == 0; });
+
+    return nes->getFrameBuffer();
+}
@@ -0,0 +1,82 @@
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <SharedMemoryLink.hpp>
+#include <NesSystem.hpp>
+
+SharedMemoryLink::SharedMemoryLink(const std::string &name, uint32_t romCrc)
+    : name{name[0] == '/' ? name : "/" + name}, segment{nullptr}, served{0}
+{
+    const int fd = shm_open(this->name.c_str(), O_CREAT | O_RDWR, 0600);
+    if (fd < 0)
+        throw std::invalid_argument("Cannot create shared memory segment " + this->name);
+
+    void *memory = MAP_FAILED;
+    if (ftruncate(fd, sizeof(ShmSegment)) == 0)
+        memory = mmap(nullptr, sizeof(ShmSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (memory == MAP_FAILED)
+    {
+        shm_unlink(this->name.c_str());
+        throw std::invalid_argument("Cannot map shared memory segment " + this->name);
+    }
+
+    // A segment left behind by an earlier run is simply taken over
+    segment = static_cast<ShmSegment *>(memory);
+    std::memset(static_cast<void *>(segment), 0, sizeof(ShmSegment));
+    segment->status.magic = SHM_MAGIC;
+    segment->status.version = SHM_VERSION;
+    segment->status.romCrc = romCrc;
+}
+
+SharedMemoryLink::~SharedMemoryLink() noexcept
+{
+    munmap(segment, sizeof(ShmSegment));
+    shm_unlink(name.c_str());
+}
+
+void SharedMemoryLink::publish(NesSystem &nes, const void *frame)
+{
+    ShmStatus &status = segment->status;
+    const uint32_t sequence = status.sequence.load(std::memory_order_relaxed);
+
+    status.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    status.served = served;
+    status.indexed = nes.getIndexedOutput();
+    status.frameCount = nes.getFrameCount();
+    std::memcpy(segment->ram, nes.captureState().ram, sizeof(segment->ram));
+    if (!frame)
+        frame = status.indexed ? static_cast<const void *>(nes.getIndexBuffer()) : nes.getFrameBuffer();
+    std::memcpy(segment->frame, frame, status.indexed ? DISPLAY::Width * DISPLAY::Height : sizeof(segment->frame));
+
+    status.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+SharedMemoryLink::Command SharedMemoryLink::waitForRequest()
+{
+    uint32_t request;
+
+    for (uint32_t polls = 0; (request = segment->control.request.load(std::memory_order_acquire)) == served; ++polls)
+    {
+        if (polls < SHM_SPIN_LIMIT)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+    served = request;
+    return static_cast<Command>(segment->control.command);
+}
+
+uint8_t SharedMemoryLink::getInput() const
+{
+    return segment->control.input;
+}
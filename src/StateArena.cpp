@@ -0,0 +1,33 @@
+#include <cstring>
+
+#include <StateArena.hpp>
+
+StateArena::StateArena(size_t blocksPerChunk) : blocksPerChunk{blocksPerChunk ? blocksPerChunk : 1} {}
+
+MachineState *StateArena::allocate()
+{
+    if (freeBlocks.empty())
+    {
+        chunks.emplace_back(new MachineState[blocksPerChunk]);
+        for (size_t i = blocksPerChunk; i > 0; --i)
+            freeBlocks.push_back(&chunks.back()[i - 1]);
+    }
+
+    MachineState *state = freeBlocks.back();
+    freeBlocks.pop_back();
+    // Assignment skips padding, so clear that first for equal states to compare and hash equal byte for byte
+    std::memset(static_cast<void *>(state), 0, sizeof(MachineState));
+    *state = MachineState{};
+
+    return state;
+}
+
+void StateArena::release(MachineState *state)
+{
+    freeBlocks.push_back(state);
+}
+
+size_t StateArena::capacity() const
+{
+    return chunks.size() * blocksPerChunk;
+}
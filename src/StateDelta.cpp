@@ -0,0 +1,76 @@
+#include <cstring>
+
+#include <StateDelta.hpp>
+
+static_assert(sizeof(MachineState) % sizeof(uint64_t) == 0, "MachineState is encoded a word at a time");
+static_assert(sizeof(MachineState) / sizeof(uint64_t) <= 0xFFFF, "run lengths are 16 bits");
+
+static const MachineState zero{};
+
+/*
+ * The number of live words comes first. Each run is then a count of
+ * unchanged words, a count of literal words, then the literal words
+ * themselves. All counts are 16 bits.
+ */
+size_t encodeState(const MachineState &state, const MachineState *reference, uint8_t *out)
+{
+    const uint64_t *words = reinterpret_cast<const uint64_t *>(&state);
+    const uint64_t *base = reinterpret_cast<const uint64_t *>(reference ? reference : &zero);
+    const uint16_t live = static_cast<uint16_t>(stateBytes(state) / sizeof(uint64_t));
+    uint8_t *const start = out;
+    size_t i = 0;
+
+    std::memcpy(out, &live, sizeof(live));
+    out += sizeof(live);
+    while (i < live)
+    {
+        const size_t zeroStart = i;
+        while (i < live && words[i] == base[i])
+            ++i;
+
+        const size_t literalStart = i;
+        while (i < live && words[i] != base[i])
+            ++i;
+
+        const uint16_t counts[2] = {static_cast<uint16_t>(literalStart - zeroStart), static_cast<uint16_t>(i - literalStart)};
+        std::memcpy(out, counts, sizeof(counts));
+        out += sizeof(counts);
+
+        for (size_t w = literalStart; w < i; ++w)
+        {
+            const uint64_t diff = words[w] ^ base[w];
+            std::memcpy(out, &diff, sizeof(diff));
+            out += sizeof(diff);
+        }
+    }
+
+    return out - start;
+}
+
+void decodeState(const uint8_t *in, const MachineState *reference, MachineState &state)
+{
+    uint64_t *words = reinterpret_cast<uint64_t *>(&state);
+    const uint64_t *base = reinterpret_cast<const uint64_t *>(reference ? reference : &zero);
+    uint16_t live;
+    size_t i = 0;
+
+    std::memcpy(&live, in, sizeof(live));
+    in += sizeof(live);
+    while (i < live)
+    {
+        uint16_t counts[2];
+        std::memcpy(counts, in, sizeof(counts));
+        in += sizeof(counts);
+
+        std::memmove(words + i, base + i, counts[0] * sizeof(uint64_t));
+        i += counts[0];
+
+        for (uint16_t w = 0; w < counts[1]; ++w, ++i)
+        {
+            uint64_t diff;
+            std::memcpy(&diff, in, sizeof(diff));
+            in += sizeof(diff);
+            words[i] = base[i] ^ diff;
+        }
+    }
+}
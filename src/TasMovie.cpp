@@ -0,0 +1,148 @@
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <TasMovie.hpp>
+#include <Crc32.hpp>
+
+TasWriter::TasWriter(uint32_t romCrc, uint8_t controllers)
+    : header{TAS_MAGIC, TAS_VERSION, controllers, 0, romCrc, 0, 0, 0, 0}, last{}
+{
+    if (controllers == 0 || controllers > TAS_MAX_CONTROLLERS)
+        throw std::invalid_argument("A TAS movie holds between 1 and 4 controllers");
+}
+
+void TasWriter::setStartState(const std::vector<uint8_t> &state)
+{
+    startState = state;
+    header.stateSize = state.size();
+}
+
+void TasWriter::push(const uint8_t *inputs)
+{
+    ++header.frameCount;
+
+    if (header.runCount > 0 && std::memcmp(last, inputs, header.controllers) == 0)
+    {
+        uint8_t *run = &runs[runs.size() - 2 - header.controllers];
+        const uint16_t repeats = run[0] | run[1] << 8;
+
+        if (repeats < TAS_MAX_RUN)
+        {
+            run[0] = (repeats + 1) & 0xFF;
+            run[1] = (repeats + 1) >> 8;
+            return;
+        }
+    }
+
+    runs.push_back(1);
+    runs.push_back(0);
+    runs.insert(runs.end(), inputs, inputs + header.controllers);
+    std::memcpy(last, inputs, header.controllers);
+    ++header.runCount;
+}
+
+uint32_t TasWriter::getFrameCount() const
+{
+    return header.frameCount;
+}
+
+bool TasWriter::save(const std::string &path)
+{
+    std::ofstream out(path, std::ofstream::binary);
+
+    header.crc = crc32(startState.data(), startState.size());
+    header.crc = crc32(runs.data(), runs.size(), header.crc);
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(startState.data()), startState.size());
+    out.write(reinterpret_cast<const char *>(runs.data()), runs.size());
+
+    return out.good();
+}
+
+TasReader::TasReader(const std::string &path) : data{nullptr}, size{0}, input{nullptr}, repeatsLeft{0}
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    struct stat info;
+
+    if (fd < 0)
+        throw std::invalid_argument("Cannot open TAS movie " + path);
+
+    if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(TasHeader))
+    {
+        size = info.st_size;
+        void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        data = mapping == MAP_FAILED ? nullptr : static_cast<const uint8_t *>(mapping);
+        if (data)
+            madvise(mapping, size, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    if (!data)
+        throw std::invalid_argument("Not a TAS movie: " + path);
+
+    std::memcpy(&header, data, sizeof(header));
+
+    const size_t runSize = 2 + header.controllers;
+    const size_t bodySize = size - sizeof(header);
+
+    const char *problem = nullptr;
+    if (header.magic != TAS_MAGIC)
+        problem = "Not a TAS movie: ";
+    else if (header.version != TAS_VERSION)
+        problem = "Unsupported TAS movie version: ";
+    else if (header.controllers == 0 || header.controllers > TAS_MAX_CONTROLLERS ||
+             bodySize != header.stateSize + static_cast<size_t>(header.runCount) * runSize)
+        problem = "Malformed TAS movie: ";
+    else if (crc32(data + sizeof(header), bodySize) != header.crc)
+        problem = "Corrupt TAS movie (CRC mismatch): ";
+
+    if (problem)
+    {
+        munmap(const_cast<uint8_t *>(data), size);
+        throw std::invalid_argument(problem + path);
+    }
+
+    nextRun = data + sizeof(header) + header.stateSize;
+    runsLeft = header.runCount;
+}
+
+TasReader::~TasReader() noexcept
+{
+    munmap(const_cast<uint8_t *>(data), size);
+}
+
+const TasHeader &TasReader::getHeader() const
+{
+    return header;
+}
+
+const uint8_t *TasReader::getStartState() const
+{
+    return header.stateSize ? data + sizeof(header) : nullptr;
+}
+
+bool TasReader::next(uint8_t *inputs)
+{
+    while (repeatsLeft == 0)
+    {
+        if (runsLeft == 0)
+            return false;
+
+        repeatsLeft = nextRun[0] | nextRun[1] << 8;
+        input = nextRun + 2;
+        nextRun += 2 + header.controllers;
+        --runsLeft;
+    }
+
+    std::memcpy(inputs, input, header.controllers);
+    --repeatsLeft;
+
+    return true;
+}
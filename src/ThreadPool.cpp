@@ -0,0 +1,104 @@
+#include <algorithm>
+
+#include <ThreadPool.hpp>
+
+ThreadPool::ThreadPool(size_t threads) : job{nullptr}, batch{0}, remaining{0}, active{0}, quit{false}
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (size_t i = 0; i < threads; ++i)
+        queues.emplace_back(new Queue);
+    for (size_t i = 0; i < threads; ++i)
+        this->threads.emplace_back(&ThreadPool::work, this, i);
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+    {
+        std::lock_guard<std::mutex> guard{lock};
+        quit = true;
+    }
+    wake.notify_all();
+
+    for (std::thread &thread : threads)
+        thread.join();
+}
+
+size_t ThreadPool::size() const
+{
+    return threads.size();
+}
+
+void ThreadPool::parallelFor(size_t count, const Job &job)
+{
+    if (count == 0)
+        return;
+
+    std::unique_lock<std::mutex> guard{lock};
+
+    for (size_t i = 0; i < queues.size(); ++i)
+    {
+        std::lock_guard<std::mutex> queueGuard{queues[i]->lock};
+        queues[i]->begin = count * i / queues.size();
+        queues[i]->end = count * (i + 1) / queues.size();
+    }
+
+    this->job = &job;
+    remaining = count;
+    ++batch;
+    wake.notify_all();
+
+    done.wait(guard, [this] { return remaining == 0 && active == 0; });
+    this->job = nullptr;
+}
+
+// Own tasks come off the front, stolen ones off the back of another queue
+bool ThreadPool::take(size_t worker, size_t &task)
+{
+    for (size_t i = 0; i < queues.size(); ++i)
+    {
+        Queue &queue = *queues[(worker + i) % queues.size()];
+        std::lock_guard<std::mutex> guard{queue.lock};
+
+        if (queue.begin != queue.end)
+        {
+            task = i == 0 ? queue.begin++ : --queue.end;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::work(size_t worker)
+{
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> guard{lock};
+
+    while (true)
+    {
+        wake.wait(guard, [this, seen] { return quit || batch != seen; });
+        if (quit)
+            return;
+
+        seen = batch;
+        if (!job)
+            continue;
+
+        const Job &current = *job;
+        ++active;
+        guard.unlock();
+
+        size_t task;
+        while (take(worker, task))
+        {
+            current(task, worker);
+            --remaining;
+        }
+
+        guard.lock();
+        if (--active == 0 && remaining == 0)
+            done.notify_all();
+    }
+}
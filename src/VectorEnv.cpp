@@ -0,0 +1,154 @@
+#include <cstring>
+#include <stdexcept>
+
+#include <VectorEnv.hpp>
+#include <NesSystem.hpp>
+#include <HwConstants.hpp>
+
+static const size_t FramePixels = DISPLAY::Width * DISPLAY::Height;
+
+static size_t bytesPerObservation(EnvConfig::Observation observation)
+{
+    switch (observation)
+    {
+    case EnvConfig::FRAME:
+        return FramePixels * sizeof(uint32_t);
+    case EnvConfig::PALETTE:
+        return FramePixels;
+    case EnvConfig::GRAYSCALE:
+        return OBSERVATION_SIZE * OBSERVATION_SIZE;
+    default:
+        return CPU::RAM::Size;
+    }
+}
+
+VectorEnv::VectorEnv(const EnvConfig &config)
+    : config{config}, reward{config.reward.empty() ? "0" : config.reward}, done{config.done.empty() ? "0" : config.done},
+      pool{config.threads}, start{new MachineState{}}, observationBytes{bytesPerObservation(config.observation)},
+      startObservation(observationBytes), observations(config.count * observationBytes), rewards(config.count), dones(config.count),
+      actions{nullptr}, frames{0}, stepJob{[this](size_t task, size_t) { stepEnv(task); }}
+{
+    for (size_t i = 0; i < config.count; ++i)
+    {
+        envs.push_back(Env{std::unique_ptr<NesSystem>{new NesSystem{NesSystem::PLAY}}, nullptr, 0, 0});
+
+        NesSystem &nes = *envs.back().nes;
+        nes.insertCartridge(config.romName);
+        nes.setIndexedOutput(config.observation == EnvConfig::PALETTE || config.observation == EnvConfig::GRAYSCALE);
+        if (config.observation == EnvConfig::GRAYSCALE)
+            envs.back().filter.reset(new ObservationFilter{nes.getPalette()});
+    }
+
+    if (envs.empty())
+        throw std::invalid_argument("An environment needs at least one console");
+
+    NesSystem &first = *envs[0].nes;
+    if (!config.startState.empty() && !first.loadState(config.startState))
+        throw std::invalid_argument("The start state is not from this build or ROM");
+
+    // The frame buffer is not state, so play one frame to have a picture that goes with the start state
+    first.skipFrame();
+    *start = first.captureState();
+    startScore = reward.evaluate(start->ram);
+    if (envs[0].filter)
+        envs[0].filter->pushFrame(first.getIndexBuffer());
+    std::memcpy(startObservation.data(), observation(0, start->ram), observationBytes);
+
+    reset();
+}
+
+VectorEnv::~VectorEnv() noexcept = default;
+
+void VectorEnv::reset()
+{
+    for (size_t i = 0; i < envs.size(); ++i)
+    {
+        resetEnv(i);
+        rewards[i] = 0;
+        dones[i] = 0;
+    }
+}
+
+void VectorEnv::resetEnv(size_t env)
+{
+    envs[env].nes->restoreState(*start);
+    envs[env].score = startScore;
+    envs[env].steps = 0;
+    if (envs[env].filter)
+        envs[env].filter->reset();
+    std::memcpy(&observations[env * observationBytes], startObservation.data(), observationBytes);
+}
+
+const void *VectorEnv::observation(size_t env, const uint8_t *ram) const
+{
+    switch (config.observation)
+    {
+    case EnvConfig::FRAME:
+        return envs[env].nes->getFrameBuffer();
+    case EnvConfig::PALETTE:
+        return envs[env].nes->getIndexBuffer();
+    case EnvConfig::GRAYSCALE:
+        return envs[env].filter->getFrame();
+    default:
+        return ram;
+    }
+}
+
+void VectorEnv::stepEnv(size_t env)
+{
+    Env &state = envs[env];
+    NesSystem &nes = *state.nes;
+
+    nes.setGameplayInput(actions[env]);
+    for (uint32_t i = 0; i < frames; ++i)
+    {
+        nes.skipFrame();
+        if (state.filter && i + 2 >= frames)
+            state.filter->pushFrame(nes.getIndexBuffer());
+    }
+
+    const uint8_t *ram = nes.captureState().ram;
+    const int64_t score = reward.evaluate(ram);
+
+    rewards[env] = static_cast<float>(score - state.score);
+    state.score = score;
+    ++state.steps;
+    dones[env] = done.evaluate(ram) != 0 || (config.maxSteps && state.steps >= config.maxSteps);
+
+    if (dones[env])
+        resetEnv(env);
+    else
+        std::memcpy(&observations[env * observationBytes], observation(env, ram), observationBytes);
+}
+
+void VectorEnv::step(const uint8_t *actions, uint32_t frames)
+{
+    this->actions = actions;
+    this->frames = frames;
+    pool.parallelFor(envs.size(), stepJob);
+}
+
+size_t VectorEnv::size() const
+{
+    return envs.size();
+}
+
+size_t VectorEnv::observationSize() const
+{
+    return observationBytes;
+}
+
+const uint8_t *VectorEnv::getObservations() const
+{
+    return observations.data();
+}
+
+const float *VectorEnv::getRewards() const
+{
+    return rewards.data();
+}
+
+const uint8_t *VectorEnv::getDones() const
+{
+    return dones.data();
+}
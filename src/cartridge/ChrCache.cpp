@@ -0,0 +1,48 @@
+#include <ChrCache.hpp>
+
+const uint64_t ChrCache::blank[2] = {0, 0};
+
+const std::array<uint64_t, 0x100> ChrCache::spread = [] {
+    std::array<uint64_t, 0x100> table{};
+
+    for (uint16_t b = 0; b < 0x100; ++b)
+        for (uint8_t p = 0; p < 8; ++p)
+            table[b] |= static_cast<uint64_t>((b >> (7 - p)) & 0x1) << (p << 3);
+
+    return table;
+}();
+
+void ChrCache::build(const uint8_t *chr, size_t size)
+{
+    const size_t tiles = size >> 4;
+
+    rows.assign(tiles << 4, 0);
+    dirty.assign(tiles, false);
+
+    for (size_t tile = 0; tile < tiles; ++tile)
+        decodeTile(chr, tile);
+}
+
+// Tiles are decoded again lazily, since CHR-RAM uploads come a byte at a time
+void ChrCache::invalidate(size_t offset)
+{
+    dirty[offset >> 4] = true;
+}
+
+void ChrCache::invalidateAll()
+{
+    dirty.assign(dirty.size(), true);
+}
+
+void ChrCache::decodeTile(const uint8_t *chr, size_t tile)
+{
+    for (uint8_t y = 0; y < 8; ++y)
+    {
+        const uint64_t pixels = decode(chr[(tile << 4) | y], chr[(tile << 4) | 0x8 | y]);
+
+        rows[((tile << 3) | y) << 1] = pixels;
+        rows[(((tile << 3) | y) << 1) | 0x1] = __builtin_bswap64(pixels);
+    }
+
+    dirty[tile] = false;
+}
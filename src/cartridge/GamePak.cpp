@@ -4,113 +4,208 @@
 #include <stdexcept>
 
 #include <GamePak.hpp>
+#include <RicohRP2C02.hpp>
+#include <Bus.hpp>
 #include <Mapper000.hpp>
-#include <SDL2/SDL.h>
+#include <Mapper001.hpp>
+#include <Mapper002.hpp>
+#include <Mapper003.hpp>
+#include <Mapper004.hpp>
+#include <Mapper007.hpp>
 
-GamePak::GamePak(const std::string &fname) : mem{PRG}
+GamePak::GamePak(const std::string &fname, CartState &state, uint8_t *ram) : state{state}
 {
-    parseFile(fname);
+    parseFile(fname, ram);
+    mapper->reset();
+    mapper->updateBanks();
+    scanlineCounter = mapper->countsScanlines();
+    state.irq = false;
 }
 
-void GamePak::parseFile(const std::string &fname)
+void GamePak::parseFile(const std::string &fname, uint8_t *ram)
 {
-    std::ifstream in;
-
     try
     {
-        in.open(fname, std::ifstream::binary);
-        in.read((char *)&header, sizeof(GameHeader));
-
-        // Validate NES ROM Checksum
-        if (header.name[0] != 'N' || header.name[1] != 'E' || header.name[2] != 'S' || header.name[3] != 0x1A)
+        rom = RomImage::load(fname);
+        header = rom->header;
+        prg = rom->prg;
+        romCrc = rom->crc;
+
+        uint8_t mapperNum = header.mapper1 >> 0x4;
+        // Old rippers signed the end of the header, which leaves byte 7 unreliable too
+        if (!(header.unused[1] | header.unused[2] | header.unused[3] | header.unused[4]))
+            mapperNum |= header.mapper2 & 0xF0;
+
+        if (header.mapper1 & 0x08)
+            state.mirrorMode = FOUR_SCREEN;
+        else
+            state.mirrorMode = (header.mapper1 & 0x01) ? VERTICAL : HORIZONTAL;
+
+        // A known game's board overrides its header; unknown ones keep 8KB of PRG RAM, which nothing minds
+        info = findRomInfo(romCrc);
+        prgRam = !info || info->prgRamBanks != 0;
+        if (info)
         {
-            throw std::ifstream::failure("Invalid ROM:\nCheck https://github.com/t6george/NESS for supported mappers/games.");
+            mapperNum = info->mapper;
+            state.mirrorMode = info->mirrorMode;
         }
 
-        if (header.mapper1 & 0x04)
+        chrRam = header.chrBanks == 0;
+        // Packed at the start of the state block's tail, so boards without RAM add nothing to the state
+        prgRamMem = prgRam ? ram : nullptr;
+        chrRamMem = chrRam ? ram + (prgRam ? CARTRIDGE::PrgRamSize : 0) : nullptr;
+        state.ramSize = (prgRam ? CARTRIDGE::PrgRamSize : 0) + (chrRam ? CARTRIDGE::ChrBankSize : 0);
+        if (chrRam)
         {
-            in.seekg(0x200, std::ios_base::cur);
+            header.chrBanks = 0x1;
+            chrMem = chrRamMem;
+            chrCache.build(chrMem, CARTRIDGE::ChrBankSize);
         }
-
-        uint8_t mapperNum = (header.mapper2 & 0xFFF0) | (header.mapper1 >> 0x4);
-        mMode = (header.mapper1 & 0x01) ? VERTICAL : HORIZONTAL;
-
-        uint8_t ftype = 1;
-
-        if (ftype == 1)
+        else
         {
-            header.chrBanks = header.chrBanks == 0 ? 0x1 : header.chrBanks;
-            prg.resize(CARTRIDGE::PrgBankSize * header.prgBanks);
-            chr.resize(CARTRIDGE::ChrBankSize * header.chrBanks);
-
-            in.read((char *)prg.data(), prg.size());
-            in.read((char *)chr.data(), chr.size());
+            chrMem = rom->chr;
         }
 
         switch (mapperNum)
         {
         case 0:
-            mapper.reset(new Mapper000(header.prgBanks, header.chrBanks));
+            mapper.reset(new Mapper000(*this));
+            break;
+        case 1:
+            mapper.reset(new Mapper001(*this));
+            break;
+        case 2:
+            mapper.reset(new Mapper002(*this));
+            break;
+        case 3:
+            mapper.reset(new Mapper003(*this));
+            break;
+        case 4:
+            mapper.reset(new Mapper004(*this));
+            break;
+        case 7:
+            mapper.reset(new Mapper007(*this));
             break;
         default:
             // Unsupported Mapper Type
             throw std::ifstream::failure("Unsupported ROM:\nCheck https://github.com/t6george/NESS for supported mappers/games.");
             break;
         }
-
-        in.close();
     }
     catch (const std::ifstream::failure &e)
     {
         std::cerr << e.what() << std::endl;
-        in.close();
         exit(0);
     }
 }
 
-inline uint8_t GamePak::getByte(uint16_t addr, bool readOnly)
+// Only the CPU bus reaches the cartridge as a device; the PPU calls readChr and writeChr
+uint8_t GamePak::getByte(uint16_t addr, bool readOnly)
 {
-    uint8_t data = 0x00;
-
-    if (mem == PRG && mapper->translatePrgAddress(addr))
-    {
-        data = prg[addr];
-    }
-    else if (mem == CHR && mapper->translateChrAddress(addr))
-    {
-        data = chr[addr];
-    }
+    return readPrg(addr + CPU::CARTRIDGE::Base);
+}
 
-    return data;
+void GamePak::setByte(uint16_t addr, uint8_t data)
+{
+    writePrg(addr + CPU::CARTRIDGE::Base, data);
 }
 
-inline void GamePak::setByte(uint16_t addr, uint8_t data)
+void GamePak::writePrg(uint16_t addr, uint8_t data)
 {
-    if (mem == PRG && mapper->translatePrgAddress(addr))
+    if (addr >= CARTRIDGE::PrgRomBase)
     {
-        prg[addr] = data;
+        const uint8_t update = mapper->writeRegister(addr, data);
+
+        if (update != Mapper::NONE)
+            mapper->updateBanks();
+        if ((update & Mapper::PRG_BANKS) && bus)
+            bus->remap(CARTRIDGE::PrgRomBase, CPU::CARTRIDGE::Limit);
+        if (update & Mapper::IRQ)
+            irqTimingChanged();
     }
-    else if (mem == CHR && mapper->translateChrAddress(addr))
+    else if (addr >= CARTRIDGE::PrgRamBase && prgRam)
     {
-        chr[addr] = data;
+        prgRamMem[addr - CARTRIDGE::PrgRamBase] = data;
     }
 }
 
-inline uint16_t GamePak::mirrorAddress(uint16_t addr, uint16_t mirror)
+void GamePak::writeChr(uint16_t addr, uint8_t data)
 {
-    if (mirror == CPU::CARTRIDGE::Mirror)
+    // CHR ROM ignores writes
+    if (chrRam)
     {
-        mem = PRG;
-    }
-    else if (mirror == PPU::CARTRIDGE::Mirror)
-    {
-        mem = CHR;
+        const size_t offset = chrOffset(addr);
+
+        chrRamMem[offset] = data;
+        chrCache.invalidate(offset);
     }
+}
+
+// The cartridge decodes its whole range itself
+uint16_t GamePak::mirrorAddress(uint16_t addr, uint16_t mirror)
+{
+    (void)mirror;
 
     return addr;
 }
 
+uint8_t *GamePak::getPage(uint16_t addr, uint16_t mirror, bool write)
+{
+    uint8_t *page = nullptr;
+    (void)mirror;
+
+    addr += CPU::CARTRIDGE::Base;
+
+    // PRG ROM writes stay on the slow path so the mapper sees them, and read pages are only ever loaded from
+    if (addr >= CARTRIDGE::PrgRomBase && !write)
+        page = const_cast<uint8_t *>(prgMap[(addr >> 13) & 0x03]) + (addr & (CARTRIDGE::PrgWindowSize - 1));
+    else if (addr >= CARTRIDGE::PrgRamBase && addr < CARTRIDGE::PrgRomBase && prgRam)
+        page = &prgRamMem[addr - CARTRIDGE::PrgRamBase];
+
+    return page;
+}
+
+size_t GamePak::chrOffset(uint16_t addr) const
+{
+    return (chrMap[addr >> 10] - chrMem) + (addr & (CARTRIDGE::ChrWindowSize - 1));
+}
+
+// Decoded pixels for the pattern row at a PPU address, as stored and flipped
+const uint64_t *GamePak::getChrRow(uint16_t addr)
+{
+    if (addr <= PPU::CARTRIDGE::Limit)
+        return chrRam ? chrCache.row(chrMem, chrOffset(addr)) : rom->chrCache.decoded(chrOffset(addr));
+
+    return ChrCache::blank;
+}
+
 GamePak::MirrorMode GamePak::getMirrorMode() const
 {
-    return mMode;
-}
\ No newline at end of file
+    return static_cast<MirrorMode>(state.mirrorMode);
+}
+
+void GamePak::setMirrorMode(MirrorMode mode)
+{
+    state.mirrorMode = mode;
+    if (ppu)
+        ppu->updateNametablePages();
+}
+
+void GamePak::stateLoaded()
+{
+    mapper->updateBanks();
+    if (chrRam)
+        chrCache.invalidateAll();
+}
+
+void GamePak::irqNotify(void (*notifier)(void *), void *data)
+{
+    irqNotifier = notifier;
+    irqData = data;
+}
+
+void GamePak::irqTimingChanged()
+{
+    if (irqNotifier)
+        irqNotifier(irqData);
+}
@@ -0,0 +1,82 @@
+#include <array>
+#include <cstddef>
+
+#include <RomDatabase.hpp>
+#include <GamePak.hpp>
+
+namespace
+{
+// Keyed by the CRC the emulator reports for a loaded game (NesSystem::getRomCrc)
+constexpr RomInfo Games[] = {
+    // Super Mario Bros.
+    {0xD445F698, 0, GamePak::VERTICAL, 0, 0, 0x8057},
+};
+
+constexpr size_t GameCount = sizeof(Games) / sizeof(Games[0]);
+
+// At least twice as many slots as games, so a multiplier that separates them all turns up quickly
+constexpr uint32_t slotBits()
+{
+    uint32_t bits = 1;
+    while ((size_t{1} << bits) < 2 * GameCount)
+        ++bits;
+    return bits;
+}
+
+constexpr uint32_t SlotBits = slotBits();
+constexpr size_t SlotCount = size_t{1} << SlotBits;
+
+constexpr uint32_t slotOf(uint32_t crc, uint32_t multiplier)
+{
+    return static_cast<uint32_t>(crc * multiplier) >> (32 - SlotBits);
+}
+
+constexpr bool separates(uint32_t multiplier)
+{
+    std::array<bool, SlotCount> used{};
+
+    for (size_t game = 0; game < GameCount; ++game)
+    {
+        const uint32_t slot = slotOf(Games[game].crc, multiplier);
+        if (used[slot])
+            return false;
+        used[slot] = true;
+    }
+    return true;
+}
+
+// The first odd multiplier from the golden ratio on that gives every game its own slot, found by the compiler
+constexpr uint32_t findMultiplier()
+{
+    for (uint32_t multiplier = 0x9E3779B1; multiplier != 0x9E3779B1 + 2 * 0x10000; multiplier += 2)
+    {
+        if (separates(multiplier))
+            return multiplier;
+    }
+    return 0;
+}
+
+constexpr uint32_t Multiplier = findMultiplier();
+static_assert(Multiplier != 0, "No multiplier hashes the ROM database without collisions; add slots");
+
+// The game in each slot, or GameCount for none
+constexpr std::array<uint16_t, SlotCount> buildSlots()
+{
+    std::array<uint16_t, SlotCount> slots{};
+
+    for (size_t slot = 0; slot < SlotCount; ++slot)
+        slots[slot] = GameCount;
+    for (size_t game = 0; game < GameCount; ++game)
+        slots[slotOf(Games[game].crc, Multiplier)] = game;
+    return slots;
+}
+
+constexpr std::array<uint16_t, SlotCount> Slots = buildSlots();
+} // namespace
+
+const RomInfo *findRomInfo(uint32_t crc)
+{
+    const uint16_t game = Slots[slotOf(crc, Multiplier)];
+
+    return game < GameCount && Games[game].crc == crc ? &Games[game] : nullptr;
+}
@@ -0,0 +1,104 @@
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <RomImage.hpp>
+#include <HwConstants.hpp>
+#include <Crc32.hpp>
+#include <Hash64.hpp>
+
+// Images alive in the process, by hash64 of the file
+static std::mutex cacheLock;
+static std::unordered_map<uint64_t, std::weak_ptr<const RomImage>> cache;
+
+RomImage::RomImage(void *mapping, size_t mappingSize, uint64_t hash)
+    : mapping{mapping}, mappingSize{mappingSize}, chr{nullptr}, chrSize{0}, hash{hash}
+{
+    const uint8_t *file = static_cast<const uint8_t *>(mapping);
+    std::memcpy(&header, file, sizeof(header));
+
+    // Validate NES ROM Checksum
+    if (header.name[0] != 'N' || header.name[1] != 'E' || header.name[2] != 'S' || header.name[3] != 0x1A)
+        throw std::ifstream::failure("Invalid ROM:\nCheck https://github.com/t6george/NESS for supported mappers/games.");
+    if (header.prgBanks == 0)
+        throw std::ifstream::failure("Invalid ROM:\nThe header declares no PRG ROM.");
+
+    // A 512 byte trainer may sit between the header and PRG ROM
+    const size_t prgOffset = sizeof(header) + ((header.mapper1 & 0x04) ? 0x200 : 0);
+    prgSize = CARTRIDGE::PrgBankSize * header.prgBanks;
+    chrSize = CARTRIDGE::ChrBankSize * header.chrBanks;
+    if (prgOffset + prgSize + chrSize > mappingSize)
+        throw std::ifstream::failure("Invalid ROM:\nThe file is shorter than its header says.");
+
+    prg = file + prgOffset;
+    if (chrSize)
+    {
+        chr = prg + prgSize;
+        chrCache.build(chr, chrSize);
+    }
+    crc = crc32(chr, chrSize, crc32(prg, prgSize));
+}
+
+RomImage::~RomImage() noexcept
+{
+    munmap(mapping, mappingSize);
+
+    // A new image may already have taken the slot of this one
+    std::lock_guard<std::mutex> guard{cacheLock};
+    auto entry = cache.find(hash);
+    if (entry != cache.end() && entry->second.expired())
+        cache.erase(entry);
+}
+
+std::shared_ptr<const RomImage> RomImage::load(const std::string &fname)
+{
+    const int fd = open(fname.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::ifstream::failure("Cannot open ROM " + fname);
+
+    struct stat info;
+    void *mapping = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(GameHeader))
+        mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED)
+        throw std::ifstream::failure("Invalid ROM:\nCannot map " + fname);
+
+    const size_t size = info.st_size;
+    const uint64_t hash = hash64(mapping, size);
+    std::shared_ptr<const RomImage> image;
+
+    {
+        std::lock_guard<std::mutex> guard{cacheLock};
+        auto entry = cache.find(hash);
+        if (entry != cache.end())
+            image = entry->second.lock();
+    }
+
+    // The file is already mapped, so one pass rules out a hash collision handing over another game
+    if (image && image->mappingSize == size && std::memcmp(image->mapping, mapping, size) == 0)
+    {
+        munmap(mapping, size);
+        return image;
+    }
+
+    try
+    {
+        image.reset(new RomImage{mapping, size, hash});
+    }
+    catch (...)
+    {
+        munmap(mapping, size);
+        throw;
+    }
+
+    std::lock_guard<std::mutex> guard{cacheLock};
+    cache[hash] = image;
+    return image;
+}
@@ -12,26 +12,16 @@
 // Nested template syntax can be damaging to the eye - I only want to write it out once :)
 #define GEN_INSTR(name, type, cycles) std::unique_ptr<MOS6502Instruction>(new name<Ricoh2A03::AddressingType::type>(this, cycles))
 
-inline uint16_t Ricoh2A03::elapsed() const
+uint8_t Ricoh2A03::readRegister(uint16_t addr)
 {
-    return FRAME_TICKS - remaining;
-}
-
-uint8_t Ricoh2A03::read(uint16_t addr, bool zpageMode)
-{
-    uint16_t mask = 0xFFFF;
-
-    if (zpageMode)
-        mask = 0x00FF;
-
-    addr &= mask;
-
     if ((0x4000 <= addr && addr <= 0x4013) || addr == 0x4015)
     {
         return apu->access<0>(elapsed(), addr, 0);
     }
 
-    return bus->read(addr & mask);
+    // Anything past here may observe or change what the PPU draws
+    Ppu->catchUp();
+    return bus->read(addr);
 }
 
 uint16_t Ricoh2A03::readDoubleWord(uint16_t addr, bool zpageMode)
@@ -40,7 +30,7 @@ uint16_t Ricoh2A03::readDoubleWord(uint16_t addr, bool zpageMode)
            (static_cast<uint16_t>(read(addr, zpageMode)));
 }
 
-void Ricoh2A03::write(uint16_t addr, uint8_t data)
+void Ricoh2A03::writeRegister(uint16_t addr, uint8_t data)
 {
     if (addr == 0x4014)
     {
@@ -58,6 +48,7 @@ void Ricoh2A03::write(uint16_t addr, uint8_t data)
     }
     else
     {
+        Ppu->catchUp();
         bus->write(addr, data);
     }
 }
@@ -86,17 +77,23 @@ uint16_t Ricoh2A03::popDoubleWord()
 }
 
 // Fetch-Execute Cycle
+template <Ricoh2A03::Core C>
 void Ricoh2A03::fetch()
 {
     if (cycles == 0)
     {
         setFlag(U, true);
         uint8_t opcode = read(PC++);
-        cycles = instructions[opcode]->exec();
+        if (C == Core::SWITCH)
+            cycles = execute(opcode);
+        else
+            cycles = instructions[opcode]->exec();
         setFlag(U, true);
     }
     --cycles;
 }
+template void Ricoh2A03::fetch<Ricoh2A03::Core::VTABLE>();
+template void Ricoh2A03::fetch<Ricoh2A03::Core::SWITCH>();
 
 void Ricoh2A03::reset()
 {
@@ -113,11 +110,12 @@ void Ricoh2A03::nmi(uint16_t interruptAddr)
 {
     // std::cout << "NMI" << std::endl;
     setFlag(U, true);
-    setFlag(I, true);
     setFlag(B, false);
 
     pushDoubleWord(PC);
+    // The status is pushed before masking, so RTI brings back the caller's I flag
     pushWord(S);
+    setFlag(I, true);
 
     PC = readDoubleWord(interruptAddr);
 
@@ -166,6 +164,7 @@ void Ricoh2A03::addCartridge(std::shared_ptr<AddressableDevice> cart)
     assert(dynamic_cast<GamePak *>(cart.get()));
 
     cartridge = cart;
+    static_cast<GamePak *>(cart.get())->bus = bus.get();
 
     bus->attachDevice(CPU::CARTRIDGE::Base,
                       CPU::CARTRIDGE::Limit,
@@ -173,8 +172,8 @@ void Ricoh2A03::addCartridge(std::shared_ptr<AddressableDevice> cart)
                       cart);
 }
 
-Ricoh2A03::Ricoh2A03(std::shared_ptr<AddressableDevice> ppu, std::shared_ptr<GamePad> p1)
-    : bus{new Bus{p1}},
+Ricoh2A03::Ricoh2A03(CpuState &state, uint8_t *ramContents, std::shared_ptr<RicohRP2C02> ppu, std::shared_ptr<GamePad> p1)
+    : state{state}, bus{new Bus{p1}},
       instructions{
           GEN_INSTR(BRK, IMM, 7), GEN_INSTR(ORA, IX, 6),
           GEN_INSTR(NOP, IMP, 2), GEN_INSTR(NOP, IMP, 8),
@@ -319,10 +318,9 @@ Ricoh2A03::Ricoh2A03(std::shared_ptr<AddressableDevice> ppu, std::shared_ptr<Gam
           GEN_INSTR(NOP, IMP, 2), GEN_INSTR(NOP, IMP, 7),
           GEN_INSTR(NOP, IMP, 4), GEN_INSTR(SBC, ABX, 4),
           GEN_INSTR(INC, ABX, 7), GEN_INSTR(INC, IMP, 7)},
-      dma_page{0x00}, dma_addr{0x00}, dma_transfer{false},
       apu{new Apu2A03()}
 {
-    ram.reset(new Ram(CPU::RAM::Size));
+    ram.reset(new Ram(ramContents));
     Ppu = ppu;
     bus->attachDevice(CPU::RAM::Base,
                       CPU::RAM::Limit,
@@ -348,4 +346,4 @@ bool Ricoh2A03::isFrameDone() const
 void Ricoh2A03::restartFrameTimer()
 {
     remaining += FRAME_TICKS;
-}
\ No newline at end of file
+}
@@ -0,0 +1,1169 @@
+#include <Ricoh2A03.hpp>
+
+/*
+ * Switch-dispatched interpreter core
+ * Mirrors the AddressingMode<T>/Instructions.hpp hierarchy one-to-one,
+ * but every addressing mode and operation is a template that the
+ * compiler inlines straight into a single dense switch, so an
+ * instruction costs one indirect jump instead of two vtable calls.
+ * Any behavioural change made to Instructions.hpp must be made here too.
+ */
+
+namespace
+{
+using AT = Ricoh2A03::AddressingType;
+
+inline void setZN(Ricoh2A03 &cpu, uint8_t val)
+{
+    cpu.setFlag(Ricoh2A03::Z, val == 0x00);
+    cpu.setFlag(Ricoh2A03::N, val & 0x80);
+}
+
+// Resolves the effective address of the operand, returns the page cross penalty
+template <AT T>
+inline uint8_t address(Ricoh2A03 &cpu, uint16_t &addr)
+{
+    uint8_t cyclePenalty = 0;
+
+    switch (T)
+    {
+    case AT::IMP:
+        addr = 0x0000;
+        break;
+    case AT::IMM:
+        addr = cpu.PC++;
+        break;
+    case AT::ZP:
+        addr = static_cast<uint16_t>(cpu.read(cpu.PC++));
+        break;
+    case AT::ZPX:
+        addr = 0x00FF & static_cast<uint16_t>(cpu.read(cpu.PC++) + cpu.X);
+        break;
+    case AT::ZPY:
+        addr = 0x00FF & static_cast<uint16_t>(cpu.read(cpu.PC++) + cpu.Y);
+        break;
+    case AT::REL:
+        addr = cpu.read(cpu.PC++);
+        addr |= ((static_cast<uint8_t>(0x80 & addr) != 0x0000) * 0xFF00);
+        break;
+    case AT::AB:
+        addr = cpu.readDoubleWord(cpu.PC);
+        cpu.PC += 0x2;
+        break;
+    case AT::ABX:
+        addr = cpu.readDoubleWord(cpu.PC) + cpu.X;
+        cpu.PC += 0x2;
+        cyclePenalty = (addr & 0xFF00) != ((addr - cpu.X) & 0xFF00);
+        break;
+    case AT::ABY:
+        addr = cpu.readDoubleWord(cpu.PC) + cpu.Y;
+        cpu.PC += 0x2;
+        cyclePenalty = (addr & 0xFF00) != ((addr - cpu.Y) & 0xFF00);
+        break;
+    case AT::IN:
+        addr = cpu.readDoubleWord(cpu.PC);
+        cpu.PC += 0x2;
+
+        // Hardware bug: wrap around if low addr byte's bits are all set (no carry is propagated)
+        if ((addr & 0x00FF) == 0x00FF)
+        {
+            addr = ((static_cast<uint16_t>(cpu.read(addr & 0xFF00)) << 8) |
+                    static_cast<uint16_t>(cpu.read(addr)));
+        }
+        else
+        {
+            addr = cpu.readDoubleWord(addr);
+        }
+        break;
+    case AT::IX:
+        addr = static_cast<uint16_t>(cpu.read(cpu.PC++)) + static_cast<uint16_t>(cpu.X);
+        addr = cpu.readDoubleWord(addr, true);
+        break;
+    case AT::IY:
+        addr = static_cast<uint16_t>(cpu.read(cpu.PC++));
+        addr = cpu.readDoubleWord(addr, true) + cpu.Y;
+        cyclePenalty = (addr & 0xFF00) != ((addr - cpu.Y) & 0xFF00);
+        break;
+    }
+
+    return cyclePenalty;
+}
+
+template <AT T>
+inline uint8_t load(Ricoh2A03 &cpu, uint16_t addr)
+{
+    if (T == AT::IMP)
+        return cpu.A;
+    else if (T == AT::ZP || T == AT::ZPX || T == AT::ZPY)
+        return cpu.read(addr, true);
+    else
+        return cpu.read(addr);
+}
+
+template <AT T>
+inline void writeBack(Ricoh2A03 &cpu, uint16_t addr, uint8_t data)
+{
+    if (T == AT::IMP)
+        cpu.A = data;
+    else
+        cpu.write(addr, data);
+}
+
+// Interrupt Instructions ------------------------------------------------------
+template <AT T>
+inline uint8_t BRK(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    ++cpu.PC;
+    cpu.setFlag(Ricoh2A03::I, true);
+    cpu.setFlag(Ricoh2A03::B, true);
+
+    cpu.pushDoubleWord(cpu.PC);
+    cpu.pushWord(cpu.S);
+
+    cpu.PC = cpu.readDoubleWord(0xFFFE);
+    cpu.setFlag(Ricoh2A03::B, false);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t RTI(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    cpu.S = cpu.popWord();
+    cpu.setFlag(Ricoh2A03::U, false);
+    cpu.setFlag(Ricoh2A03::B, false);
+
+    cpu.PC = cpu.popDoubleWord();
+    return numCycles;
+}
+
+// Subroutine Instructions ------------------------------------------------------
+template <AT T>
+inline uint8_t JSR(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    address<T>(cpu, addr);
+    cpu.pushDoubleWord(cpu.PC - 1);
+    cpu.PC = addr;
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t RTS(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    cpu.PC = cpu.popDoubleWord();
+    ++cpu.PC;
+    return numCycles;
+}
+
+// Direct Stack Intructions ------------------------------------------------------
+template <AT T>
+inline uint8_t PLA(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    cpu.A = cpu.popWord();
+    setZN(cpu, cpu.A);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t PHA(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    cpu.pushWord(cpu.A);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t PLP(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    cpu.S = cpu.popWord();
+    cpu.setFlag(Ricoh2A03::U, true);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t PHP(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    cpu.setFlag(Ricoh2A03::U, true);
+    cpu.setFlag(Ricoh2A03::B, true);
+
+    cpu.pushWord(cpu.S);
+
+    cpu.setFlag(Ricoh2A03::U, false);
+    cpu.setFlag(Ricoh2A03::B, false);
+    return numCycles;
+}
+
+// Load Instructions ------------------------------------------------------
+template <AT T>
+inline uint8_t LDA(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    uint8_t cyclePenalty = address<T>(cpu, addr);
+    cpu.A = load<T>(cpu, addr);
+    setZN(cpu, cpu.A);
+    return numCycles + cyclePenalty;
+}
+
+template <AT T>
+inline uint8_t LDX(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    uint8_t cyclePenalty = address<T>(cpu, addr);
+    cpu.X = load<T>(cpu, addr);
+    setZN(cpu, cpu.X);
+    return numCycles + cyclePenalty;
+}
+
+template <AT T>
+inline uint8_t LDY(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    uint8_t cyclePenalty = address<T>(cpu, addr);
+    cpu.Y = load<T>(cpu, addr);
+    setZN(cpu, cpu.Y);
+    return numCycles + cyclePenalty;
+}
+
+// Store Instructions ------------------------------------------------------
+template <AT T>
+inline uint8_t STA(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    address<T>(cpu, addr);
+    writeBack<T>(cpu, addr, cpu.A);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t STX(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    address<T>(cpu, addr);
+    writeBack<T>(cpu, addr, cpu.X);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t STY(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    address<T>(cpu, addr);
+    writeBack<T>(cpu, addr, cpu.Y);
+    return numCycles;
+}
+
+// Register Transfer Instructions ------------------------------------------------------
+template <AT T>
+inline uint8_t TAX(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    cpu.X = cpu.A;
+    setZN(cpu, cpu.X);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t TXA(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    cpu.A = cpu.X;
+    setZN(cpu, cpu.A);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t TSX(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    cpu.X = cpu.SP;
+    setZN(cpu, cpu.X);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t TXS(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    cpu.SP = cpu.X;
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t TAY(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    cpu.Y = cpu.A;
+    setZN(cpu, cpu.Y);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t TYA(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    cpu.A = cpu.Y;
+    setZN(cpu, cpu.A);
+    return numCycles;
+}
+
+// Branch Instructions ------------------------------------------------------
+template <AT T>
+inline uint8_t branchIf(Ricoh2A03 &cpu, uint8_t numCycles, Ricoh2A03::Flags6502 f, bool set)
+{
+    uint16_t addr;
+    address<T>(cpu, addr);
+    return numCycles + cpu.branch(addr, cpu.getFlag(f) == set);
+}
+
+template <AT T>
+inline uint8_t BEQ(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    return branchIf<T>(cpu, numCycles, Ricoh2A03::Z, true);
+}
+
+template <AT T>
+inline uint8_t BNE(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    return branchIf<T>(cpu, numCycles, Ricoh2A03::Z, false);
+}
+
+template <AT T>
+inline uint8_t BCS(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    return branchIf<T>(cpu, numCycles, Ricoh2A03::C, true);
+}
+
+template <AT T>
+inline uint8_t BCC(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    return branchIf<T>(cpu, numCycles, Ricoh2A03::C, false);
+}
+
+template <AT T>
+inline uint8_t BVS(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    return branchIf<T>(cpu, numCycles, Ricoh2A03::V, true);
+}
+
+template <AT T>
+inline uint8_t BVC(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    return branchIf<T>(cpu, numCycles, Ricoh2A03::V, false);
+}
+
+template <AT T>
+inline uint8_t BMI(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    return branchIf<T>(cpu, numCycles, Ricoh2A03::N, true);
+}
+
+template <AT T>
+inline uint8_t BPL(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    return branchIf<T>(cpu, numCycles, Ricoh2A03::N, false);
+}
+
+// Increment/Decrement Instructions ------------------------------------------------------
+template <AT T>
+inline uint8_t INC(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    address<T>(cpu, addr);
+    uint8_t data = load<T>(cpu, addr) + 1;
+    writeBack<T>(cpu, addr, data);
+    setZN(cpu, data);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t DEC(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    address<T>(cpu, addr);
+    uint8_t data = load<T>(cpu, addr) - 1;
+    writeBack<T>(cpu, addr, data);
+    setZN(cpu, data);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t INX(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    ++cpu.X;
+    setZN(cpu, cpu.X);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t DEX(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    --cpu.X;
+    setZN(cpu, cpu.X);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t INY(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    ++cpu.Y;
+    setZN(cpu, cpu.Y);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t DEY(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    --cpu.Y;
+    setZN(cpu, cpu.Y);
+    return numCycles;
+}
+
+// Compare Instructions ------------------------------------------------------
+template <AT T>
+inline uint8_t compare(Ricoh2A03 &cpu, uint8_t reg, uint8_t &cyclePenalty)
+{
+    uint16_t addr;
+    cyclePenalty = address<T>(cpu, addr);
+    uint8_t data = load<T>(cpu, addr);
+    setZN(cpu, reg - data);
+    cpu.setFlag(Ricoh2A03::C, reg >= data);
+    return data;
+}
+
+template <AT T>
+inline uint8_t CMP(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint8_t cyclePenalty;
+    compare<T>(cpu, cpu.A, cyclePenalty);
+    return numCycles + cyclePenalty;
+}
+
+template <AT T>
+inline uint8_t CPX(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint8_t cyclePenalty;
+    compare<T>(cpu, cpu.X, cyclePenalty);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t CPY(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint8_t cyclePenalty;
+    compare<T>(cpu, cpu.Y, cyclePenalty);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t BIT(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    address<T>(cpu, addr);
+    uint8_t data = load<T>(cpu, addr);
+    cpu.setFlag(Ricoh2A03::N, data & 0x80);
+    cpu.setFlag(Ricoh2A03::V, data & 0x40);
+    cpu.setFlag(Ricoh2A03::Z, (data & cpu.A) == 0x00);
+    return numCycles;
+}
+
+// Set/Reset Flag Instructions ------------------------------------------------------
+template <AT T>
+inline uint8_t SEC(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    cpu.setFlag(Ricoh2A03::C, true);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t CLC(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    cpu.setFlag(Ricoh2A03::C, false);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t SED(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    cpu.setFlag(Ricoh2A03::D, true);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t CLD(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    cpu.setFlag(Ricoh2A03::D, false);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t SEI(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    cpu.setFlag(Ricoh2A03::I, true);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t CLI(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    cpu.setFlag(Ricoh2A03::I, false);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t CLV(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    cpu.setFlag(Ricoh2A03::V, false);
+    return numCycles;
+}
+
+// Bitwise Logic Instructions ------------------------------------------------------
+template <AT T>
+inline uint8_t AND(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    uint8_t cyclePenalty = address<T>(cpu, addr);
+    cpu.A &= load<T>(cpu, addr);
+    setZN(cpu, cpu.A);
+    return numCycles + cyclePenalty;
+}
+
+template <AT T>
+inline uint8_t ORA(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    uint8_t cyclePenalty = address<T>(cpu, addr);
+    cpu.A |= load<T>(cpu, addr);
+    setZN(cpu, cpu.A);
+    return numCycles + cyclePenalty;
+}
+
+template <AT T>
+inline uint8_t EOR(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    uint8_t cyclePenalty = address<T>(cpu, addr);
+    cpu.A ^= load<T>(cpu, addr);
+    setZN(cpu, cpu.A);
+    return numCycles + cyclePenalty;
+}
+
+template <AT T>
+inline uint8_t LSR(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    address<T>(cpu, addr);
+    uint8_t data = load<T>(cpu, addr);
+    cpu.setFlag(Ricoh2A03::C, data & 0x01);
+    data >>= 1;
+    writeBack<T>(cpu, addr, data);
+    setZN(cpu, data);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t ASL(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    address<T>(cpu, addr);
+    uint8_t data = load<T>(cpu, addr);
+    cpu.setFlag(Ricoh2A03::C, data & 0x80);
+    data <<= 1;
+    writeBack<T>(cpu, addr, data);
+    setZN(cpu, data);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t ROR(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    address<T>(cpu, addr);
+    uint8_t data = load<T>(cpu, addr);
+    uint8_t oldCarry = static_cast<uint8_t>(cpu.getFlag(Ricoh2A03::C)) << 7;
+    cpu.setFlag(Ricoh2A03::C, data & 0x01);
+    data = (data >> 1) | oldCarry;
+    writeBack<T>(cpu, addr, data);
+    setZN(cpu, data);
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t ROL(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    address<T>(cpu, addr);
+    uint8_t data = load<T>(cpu, addr);
+    uint8_t oldCarry = static_cast<uint8_t>(cpu.getFlag(Ricoh2A03::C));
+    cpu.setFlag(Ricoh2A03::C, data & 0x80);
+    data = (data << 1) | oldCarry;
+    writeBack<T>(cpu, addr, data);
+    setZN(cpu, data);
+    return numCycles;
+}
+
+// Arithmetic Instructions ------------------------------------------------------
+inline void addWithCarry(Ricoh2A03 &cpu, uint8_t data, uint8_t overflowOperand)
+{
+    uint16_t overflowCheck = cpu.A + data +
+                             static_cast<uint8_t>(cpu.getFlag(Ricoh2A03::C));
+
+    cpu.setFlag(Ricoh2A03::C, overflowCheck & 0xFF00);
+    cpu.setFlag(Ricoh2A03::V,
+                overflowOperand & (cpu.A ^ static_cast<uint8_t>(overflowCheck)) & 0x80);
+    cpu.A = overflowCheck & 0xFF;
+    setZN(cpu, cpu.A);
+}
+
+template <AT T>
+inline uint8_t ADC(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    uint8_t cyclePenalty = address<T>(cpu, addr);
+    uint8_t data = load<T>(cpu, addr);
+    addWithCarry(cpu, data, ~(cpu.A ^ data));
+    return numCycles + cyclePenalty;
+}
+
+template <AT T>
+inline uint8_t SBC(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    uint8_t cyclePenalty = address<T>(cpu, addr);
+    uint8_t data = ~load<T>(cpu, addr);
+    uint8_t result = cpu.A + data + static_cast<uint8_t>(cpu.getFlag(Ricoh2A03::C));
+    addWithCarry(cpu, data, data ^ result);
+    return numCycles + cyclePenalty;
+}
+
+// MISC ------------------------------------------------------
+template <AT T>
+inline uint8_t JMP(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    uint16_t addr;
+    address<T>(cpu, addr);
+    cpu.PC = addr;
+    return numCycles;
+}
+
+template <AT T>
+inline uint8_t NOP(Ricoh2A03 &cpu, uint8_t numCycles)
+{
+    (void)cpu;
+    return numCycles;
+}
+
+} // namespace
+
+uint8_t Ricoh2A03::execute(uint8_t opcode)
+{
+    switch (opcode)
+    {
+    case 0x00:
+        return BRK<AT::IMM>(*this, 7);
+    case 0x01:
+        return ORA<AT::IX>(*this, 6);
+    case 0x02:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x03:
+        return NOP<AT::IMP>(*this, 8);
+    case 0x04:
+        return NOP<AT::IMP>(*this, 3);
+    case 0x05:
+        return ORA<AT::ZP>(*this, 3);
+    case 0x06:
+        return ASL<AT::ZP>(*this, 5);
+    case 0x07:
+        return NOP<AT::IMP>(*this, 5);
+    case 0x08:
+        return PHP<AT::IMP>(*this, 3);
+    case 0x09:
+        return ORA<AT::IMM>(*this, 2);
+    case 0x0A:
+        return ASL<AT::IMP>(*this, 2);
+    case 0x0B:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x0C:
+        return NOP<AT::IMP>(*this, 4);
+    case 0x0D:
+        return ORA<AT::AB>(*this, 4);
+    case 0x0E:
+        return ASL<AT::AB>(*this, 6);
+    case 0x0F:
+        return NOP<AT::IMP>(*this, 6);
+    case 0x10:
+        return BPL<AT::REL>(*this, 2);
+    case 0x11:
+        return ORA<AT::IY>(*this, 5);
+    case 0x12:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x13:
+        return NOP<AT::IMP>(*this, 8);
+    case 0x14:
+        return NOP<AT::IMP>(*this, 4);
+    case 0x15:
+        return ORA<AT::ZPX>(*this, 4);
+    case 0x16:
+        return ASL<AT::ZPX>(*this, 6);
+    case 0x17:
+        return NOP<AT::IMP>(*this, 6);
+    case 0x18:
+        return CLC<AT::IMP>(*this, 2);
+    case 0x19:
+        return ORA<AT::ABY>(*this, 4);
+    case 0x1A:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x1B:
+        return NOP<AT::IMP>(*this, 7);
+    case 0x1C:
+        return NOP<AT::IMP>(*this, 4);
+    case 0x1D:
+        return ORA<AT::ABX>(*this, 4);
+    case 0x1E:
+        return ASL<AT::ABX>(*this, 7);
+    case 0x1F:
+        return NOP<AT::IMP>(*this, 7);
+    case 0x20:
+        return JSR<AT::AB>(*this, 6);
+    case 0x21:
+        return AND<AT::IX>(*this, 6);
+    case 0x22:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x23:
+        return NOP<AT::IMP>(*this, 8);
+    case 0x24:
+        return BIT<AT::ZP>(*this, 3);
+    case 0x25:
+        return AND<AT::ZP>(*this, 3);
+    case 0x26:
+        return ROL<AT::ZP>(*this, 5);
+    case 0x27:
+        return NOP<AT::IMP>(*this, 5);
+    case 0x28:
+        return PLP<AT::IMP>(*this, 4);
+    case 0x29:
+        return AND<AT::IMM>(*this, 2);
+    case 0x2A:
+        return ROL<AT::IMP>(*this, 2);
+    case 0x2B:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x2C:
+        return BIT<AT::AB>(*this, 4);
+    case 0x2D:
+        return AND<AT::AB>(*this, 4);
+    case 0x2E:
+        return ROL<AT::AB>(*this, 6);
+    case 0x2F:
+        return NOP<AT::IMP>(*this, 6);
+    case 0x30:
+        return BMI<AT::REL>(*this, 2);
+    case 0x31:
+        return AND<AT::IY>(*this, 5);
+    case 0x32:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x33:
+        return NOP<AT::IMP>(*this, 8);
+    case 0x34:
+        return NOP<AT::IMP>(*this, 4);
+    case 0x35:
+        return AND<AT::ZPX>(*this, 4);
+    case 0x36:
+        return ROL<AT::ZPX>(*this, 6);
+    case 0x37:
+        return NOP<AT::IMP>(*this, 6);
+    case 0x38:
+        return SEC<AT::IMP>(*this, 2);
+    case 0x39:
+        return AND<AT::ABY>(*this, 4);
+    case 0x3A:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x3B:
+        return NOP<AT::IMP>(*this, 7);
+    case 0x3C:
+        return NOP<AT::IMP>(*this, 4);
+    case 0x3D:
+        return AND<AT::ABX>(*this, 4);
+    case 0x3E:
+        return ROL<AT::ABX>(*this, 7);
+    case 0x3F:
+        return NOP<AT::IMP>(*this, 7);
+    case 0x40:
+        return RTI<AT::IMP>(*this, 6);
+    case 0x41:
+        return EOR<AT::IX>(*this, 6);
+    case 0x42:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x43:
+        return NOP<AT::IMP>(*this, 8);
+    case 0x44:
+        return NOP<AT::IMP>(*this, 3);
+    case 0x45:
+        return EOR<AT::ZP>(*this, 3);
+    case 0x46:
+        return LSR<AT::ZP>(*this, 5);
+    case 0x47:
+        return NOP<AT::IMP>(*this, 5);
+    case 0x48:
+        return PHA<AT::IMP>(*this, 3);
+    case 0x49:
+        return EOR<AT::IMM>(*this, 2);
+    case 0x4A:
+        return LSR<AT::IMP>(*this, 2);
+    case 0x4B:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x4C:
+        return JMP<AT::AB>(*this, 3);
+    case 0x4D:
+        return EOR<AT::AB>(*this, 4);
+    case 0x4E:
+        return LSR<AT::AB>(*this, 6);
+    case 0x4F:
+        return NOP<AT::IMP>(*this, 6);
+    case 0x50:
+        return BVC<AT::REL>(*this, 2);
+    case 0x51:
+        return EOR<AT::IY>(*this, 5);
+    case 0x52:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x53:
+        return NOP<AT::IMP>(*this, 8);
+    case 0x54:
+        return NOP<AT::IMP>(*this, 4);
+    case 0x55:
+        return EOR<AT::ZPX>(*this, 4);
+    case 0x56:
+        return LSR<AT::ZPX>(*this, 6);
+    case 0x57:
+        return NOP<AT::IMP>(*this, 6);
+    case 0x58:
+        return CLI<AT::IMP>(*this, 2);
+    case 0x59:
+        return EOR<AT::ABY>(*this, 4);
+    case 0x5A:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x5B:
+        return NOP<AT::IMP>(*this, 7);
+    case 0x5C:
+        return NOP<AT::IMP>(*this, 4);
+    case 0x5D:
+        return EOR<AT::ABX>(*this, 4);
+    case 0x5E:
+        return LSR<AT::ABX>(*this, 7);
+    case 0x5F:
+        return NOP<AT::IMP>(*this, 7);
+    case 0x60:
+        return RTS<AT::IMP>(*this, 6);
+    case 0x61:
+        return ADC<AT::IX>(*this, 6);
+    case 0x62:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x63:
+        return NOP<AT::IMP>(*this, 8);
+    case 0x64:
+        return NOP<AT::IMP>(*this, 3);
+    case 0x65:
+        return ADC<AT::ZP>(*this, 3);
+    case 0x66:
+        return ROR<AT::ZP>(*this, 5);
+    case 0x67:
+        return NOP<AT::IMP>(*this, 5);
+    case 0x68:
+        return PLA<AT::IMP>(*this, 4);
+    case 0x69:
+        return ADC<AT::IMM>(*this, 2);
+    case 0x6A:
+        return ROR<AT::IMP>(*this, 2);
+    case 0x6B:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x6C:
+        return JMP<AT::IN>(*this, 5);
+    case 0x6D:
+        return ADC<AT::AB>(*this, 4);
+    case 0x6E:
+        return ROR<AT::AB>(*this, 6);
+    case 0x6F:
+        return NOP<AT::IMP>(*this, 6);
+    case 0x70:
+        return BVS<AT::REL>(*this, 2);
+    case 0x71:
+        return ADC<AT::IY>(*this, 5);
+    case 0x72:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x73:
+        return NOP<AT::IMP>(*this, 8);
+    case 0x74:
+        return NOP<AT::IMP>(*this, 4);
+    case 0x75:
+        return ADC<AT::ZPX>(*this, 4);
+    case 0x76:
+        return ROR<AT::ZPX>(*this, 6);
+    case 0x77:
+        return NOP<AT::IMP>(*this, 6);
+    case 0x78:
+        return SEI<AT::IMP>(*this, 2);
+    case 0x79:
+        return ADC<AT::ABY>(*this, 4);
+    case 0x7A:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x7B:
+        return NOP<AT::IMP>(*this, 7);
+    case 0x7C:
+        return NOP<AT::IMP>(*this, 4);
+    case 0x7D:
+        return ADC<AT::ABX>(*this, 4);
+    case 0x7E:
+        return ROR<AT::ABX>(*this, 7);
+    case 0x7F:
+        return NOP<AT::IMP>(*this, 7);
+    case 0x80:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x81:
+        return STA<AT::IX>(*this, 6);
+    case 0x82:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x83:
+        return NOP<AT::IMP>(*this, 6);
+    case 0x84:
+        return STY<AT::ZP>(*this, 3);
+    case 0x85:
+        return STA<AT::ZP>(*this, 3);
+    case 0x86:
+        return STX<AT::ZP>(*this, 3);
+    case 0x87:
+        return NOP<AT::IMP>(*this, 3);
+    case 0x88:
+        return DEY<AT::IMP>(*this, 2);
+    case 0x89:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x8A:
+        return TXA<AT::IMP>(*this, 2);
+    case 0x8B:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x8C:
+        return STY<AT::AB>(*this, 4);
+    case 0x8D:
+        return STA<AT::AB>(*this, 4);
+    case 0x8E:
+        return STX<AT::AB>(*this, 4);
+    case 0x8F:
+        return NOP<AT::IMP>(*this, 4);
+    case 0x90:
+        return BCC<AT::REL>(*this, 2);
+    case 0x91:
+        return STA<AT::IY>(*this, 6);
+    case 0x92:
+        return NOP<AT::IMP>(*this, 2);
+    case 0x93:
+        return NOP<AT::IMP>(*this, 6);
+    case 0x94:
+        return STY<AT::ZPX>(*this, 4);
+    case 0x95:
+        return STA<AT::ZPX>(*this, 4);
+    case 0x96:
+        return STX<AT::ZPY>(*this, 4);
+    case 0x97:
+        return NOP<AT::IMP>(*this, 4);
+    case 0x98:
+        return TYA<AT::IMP>(*this, 2);
+    case 0x99:
+        return STA<AT::ABY>(*this, 5);
+    case 0x9A:
+        return TXS<AT::IMP>(*this, 2);
+    case 0x9B:
+        return NOP<AT::IMP>(*this, 5);
+    case 0x9C:
+        return NOP<AT::IMP>(*this, 5);
+    case 0x9D:
+        return STA<AT::ABX>(*this, 5);
+    case 0x9E:
+        return NOP<AT::IMP>(*this, 5);
+    case 0x9F:
+        return NOP<AT::IMP>(*this, 5);
+    case 0xA0:
+        return LDY<AT::IMM>(*this, 2);
+    case 0xA1:
+        return LDA<AT::IX>(*this, 6);
+    case 0xA2:
+        return LDX<AT::IMM>(*this, 2);
+    case 0xA3:
+        return NOP<AT::IMP>(*this, 6);
+    case 0xA4:
+        return LDY<AT::ZP>(*this, 3);
+    case 0xA5:
+        return LDA<AT::ZP>(*this, 3);
+    case 0xA6:
+        return LDX<AT::ZP>(*this, 3);
+    case 0xA7:
+        return NOP<AT::IMP>(*this, 3);
+    case 0xA8:
+        return TAY<AT::IMP>(*this, 2);
+    case 0xA9:
+        return LDA<AT::IMM>(*this, 2);
+    case 0xAA:
+        return TAX<AT::IMP>(*this, 2);
+    case 0xAB:
+        return NOP<AT::IMP>(*this, 2);
+    case 0xAC:
+        return LDY<AT::AB>(*this, 4);
+    case 0xAD:
+        return LDA<AT::AB>(*this, 4);
+    case 0xAE:
+        return LDX<AT::AB>(*this, 4);
+    case 0xAF:
+        return NOP<AT::IMP>(*this, 4);
+    case 0xB0:
+        return BCS<AT::REL>(*this, 2);
+    case 0xB1:
+        return LDA<AT::IY>(*this, 5);
+    case 0xB2:
+        return NOP<AT::IMP>(*this, 2);
+    case 0xB3:
+        return NOP<AT::IMP>(*this, 5);
+    case 0xB4:
+        return LDY<AT::ZPX>(*this, 4);
+    case 0xB5:
+        return LDA<AT::ZPX>(*this, 4);
+    case 0xB6:
+        return LDX<AT::ZPY>(*this, 4);
+    case 0xB7:
+        return NOP<AT::IMP>(*this, 4);
+    case 0xB8:
+        return CLV<AT::IMP>(*this, 2);
+    case 0xB9:
+        return LDA<AT::ABY>(*this, 4);
+    case 0xBA:
+        return TSX<AT::IMP>(*this, 2);
+    case 0xBB:
+        return NOP<AT::IMP>(*this, 4);
+    case 0xBC:
+        return LDY<AT::ABX>(*this, 4);
+    case 0xBD:
+        return LDA<AT::ABX>(*this, 4);
+    case 0xBE:
+        return LDX<AT::ABY>(*this, 4);
+    case 0xBF:
+        return NOP<AT::IMP>(*this, 4);
+    case 0xC0:
+        return CPY<AT::IMM>(*this, 2);
+    case 0xC1:
+        return CMP<AT::IX>(*this, 6);
+    case 0xC2:
+        return NOP<AT::IMP>(*this, 2);
+    case 0xC3:
+        return NOP<AT::IMP>(*this, 8);
+    case 0xC4:
+        return CPY<AT::ZP>(*this, 3);
+    case 0xC5:
+        return CMP<AT::ZP>(*this, 3);
+    case 0xC6:
+        return DEC<AT::ZP>(*this, 5);
+    case 0xC7:
+        return NOP<AT::IMP>(*this, 5);
+    case 0xC8:
+        return INY<AT::IMP>(*this, 2);
+    case 0xC9:
+        return CMP<AT::IMM>(*this, 2);
+    case 0xCA:
+        return DEX<AT::IMP>(*this, 2);
+    case 0xCB:
+        return NOP<AT::IMP>(*this, 2);
+    case 0xCC:
+        return CPY<AT::AB>(*this, 4);
+    case 0xCD:
+        return CMP<AT::AB>(*this, 4);
+    case 0xCE:
+        return DEC<AT::AB>(*this, 6);
+    case 0xCF:
+        return NOP<AT::IMP>(*this, 6);
+    case 0xD0:
+        return BNE<AT::REL>(*this, 2);
+    case 0xD1:
+        return CMP<AT::IY>(*this, 5);
+    case 0xD2:
+        return NOP<AT::IMP>(*this, 2);
+    case 0xD3:
+        return NOP<AT::IMP>(*this, 8);
+    case 0xD4:
+        return NOP<AT::IMP>(*this, 4);
+    case 0xD5:
+        return CMP<AT::ZPX>(*this, 4);
+    case 0xD6:
+        return DEC<AT::ZPX>(*this, 6);
+    case 0xD7:
+        return NOP<AT::IMP>(*this, 6);
+    case 0xD8:
+        return CLD<AT::IMP>(*this, 2);
+    case 0xD9:
+        return CMP<AT::ABY>(*this, 4);
+    case 0xDA:
+        return NOP<AT::IMP>(*this, 2);
+    case 0xDB:
+        return NOP<AT::IMP>(*this, 7);
+    case 0xDC:
+        return NOP<AT::IMP>(*this, 4);
+    case 0xDD:
+        return CMP<AT::ABX>(*this, 4);
+    case 0xDE:
+        return DEC<AT::ABX>(*this, 7);
+    case 0xDF:
+        return NOP<AT::IMP>(*this, 7);
+    case 0xE0:
+        return CPX<AT::IMM>(*this, 2);
+    case 0xE1:
+        return SBC<AT::IX>(*this, 6);
+    case 0xE2:
+        return NOP<AT::IMP>(*this, 2);
+    case 0xE3:
+        return NOP<AT::IMP>(*this, 8);
+    case 0xE4:
+        return CPX<AT::ZP>(*this, 3);
+    case 0xE5:
+        return SBC<AT::ZP>(*this, 3);
+    case 0xE6:
+        return INC<AT::ZP>(*this, 5);
+    case 0xE7:
+        return NOP<AT::IMP>(*this, 5);
+    case 0xE8:
+        return INX<AT::IMP>(*this, 2);
+    case 0xE9:
+        return SBC<AT::IMM>(*this, 2);
+    case 0xEA:
+        return NOP<AT::IMP>(*this, 2);
+    case 0xEB:
+        return SBC<AT::IMP>(*this, 2);
+    case 0xEC:
+        return CPX<AT::AB>(*this, 4);
+    case 0xED:
+        return SBC<AT::AB>(*this, 4);
+    case 0xEE:
+        return INC<AT::AB>(*this, 6);
+    case 0xEF:
+        return NOP<AT::IMP>(*this, 6);
+    case 0xF0:
+        return BEQ<AT::REL>(*this, 2);
+    case 0xF1:
+        return SBC<AT::IY>(*this, 5);
+    case 0xF2:
+        return NOP<AT::IMP>(*this, 2);
+    case 0xF3:
+        return NOP<AT::IMP>(*this, 8);
+    case 0xF4:
+        return NOP<AT::IMP>(*this, 4);
+    case 0xF5:
+        return SBC<AT::ZPX>(*this, 4);
+    case 0xF6:
+        return INC<AT::ZPX>(*this, 6);
+    case 0xF7:
+        return NOP<AT::IMP>(*this, 6);
+    case 0xF8:
+        return SED<AT::IMP>(*this, 2);
+    case 0xF9:
+        return SBC<AT::ABY>(*this, 4);
+    case 0xFA:
+        return NOP<AT::IMP>(*this, 2);
+    case 0xFB:
+        return NOP<AT::IMP>(*this, 7);
+    case 0xFC:
+        return NOP<AT::IMP>(*this, 4);
+    case 0xFD:
+        return SBC<AT::ABX>(*this, 4);
+    case 0xFE:
+        return INC<AT::ABX>(*this, 7);
+    case 0xFF:
+        return INC<AT::IMP>(*this, 7);
+    }
+
+    return 0;
+}
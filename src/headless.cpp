@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <NesSystem.hpp>
+#include <HashLog.hpp>
+#include <SharedMemoryLink.hpp>
+
+/*
+ * Replays a movie as fast as possible, logging a hash of each subsystem
+ * after every frame. With a reference log, reports the first frame and
+ * subsystem where the two runs part ways and exits with status 2.
+ */
+static int verify(int argc, char *argv[])
+{
+    NesSystem nes(NesSystem::PLAY_TAS, argv[3]);
+    nes.insertCartridge(argv[2]);
+
+    HashLog log(nes.getRomCrc());
+    while (nes.loadGameplayInput())
+    {
+        nes.runFrame();
+        log.push(HashLog::hashFrame(nes));
+    }
+
+    if (!log.save(argv[4]))
+    {
+        std::cerr << "Could not write the hash log to " << argv[4] << std::endl;
+        return 1;
+    }
+
+    if (argc < 6)
+    {
+        std::cout << log.size() << " frames logged to " << argv[4] << std::endl;
+        return 0;
+    }
+
+    HashLog reference;
+    reference.load(argv[5]);
+    if (reference.getRomCrc() != log.getRomCrc())
+        throw std::invalid_argument("The reference log was made with a different ROM");
+
+    const size_t frame = log.firstDivergence(reference);
+    if (frame == HashLog::NoDivergence)
+    {
+        std::cout << log.size() << " frames match the reference" << std::endl;
+        return 0;
+    }
+
+    std::cout << "Diverged at frame " << frame + 1 << ": ";
+    if (frame == log.size() || frame == reference.size())
+    {
+        std::cout << (frame == log.size() ? "the movie" : "the reference") << " ends first" << std::endl;
+        return 2;
+    }
+
+    const char *separator = "";
+    for (int i = 0; i < FrameHashes::Count; ++i)
+    {
+        if (log[frame].hash[i] != reference[frame].hash[i])
+        {
+            std::cout << separator << FrameHashes::name(static_cast<FrameHashes::Subsystem>(i));
+            separator = ", ";
+        }
+    }
+    std::cout << " differ" << std::endl;
+
+    return 2;
+}
+
+/*
+ * Hands the console to an agent in another process: every request over
+ * the shared-memory segment steps it a few frames with the agent's input
+ * or resets it, and the resulting frame and RAM are published back.
+ */
+static int serve(int argc, char *argv[])
+{
+    const uint32_t framesPerStep = argc > 4 ? std::max(1ul, std::stoul(argv[4])) : 1;
+    NesSystem nes(NesSystem::PLAY);
+
+    nes.insertCartridge(argv[2]);
+    nes.setIndexedOutput(argc > 5 && !strcmp(argv[5], "indexed"));
+
+    // The frame buffer is not state, so play one frame and keep its picture to publish with every reset
+    nes.skipFrame();
+    const MachineState start = nes.captureState();
+    const uint8_t *const frame = nes.getIndexedOutput() ? nes.getIndexBuffer() : reinterpret_cast<const uint8_t *>(nes.getFrameBuffer());
+    const std::vector<uint8_t> startFrame(frame, frame + DISPLAY::Width * DISPLAY::Height * (nes.getIndexedOutput() ? 1 : sizeof(uint32_t)));
+    SharedMemoryLink link(argv[3], nes.getRomCrc());
+
+    std::cout << "Serving " << argv[2] << " on shared memory segment " << argv[3] << std::endl;
+    link.publish(nes);
+
+    while (true)
+    {
+        const uint8_t *picture = nullptr;
+
+        switch (link.waitForRequest())
+        {
+        case SharedMemoryLink::QUIT:
+            return 0;
+        case SharedMemoryLink::RESET:
+            nes.restoreState(start);
+            picture = startFrame.data();
+            break;
+        default:
+            nes.setGameplayInput(link.getInput());
+            for (uint32_t i = 0; i < framesPerStep; ++i)
+                nes.skipFrame();
+            break;
+        }
+
+        link.publish(nes, picture);
+    }
+}
+
+/*
+ * Runs a ROM with no window, audio device or frame pacing, either for a
+ * fixed number of frames or until a TAS script runs out of input.
+ */
+int main(int argc, char *argv[])
+{
+    try
+    {
+        if (argc >= 5 && argc <= 6 && !strcmp(argv[1], "verify"))
+        {
+            return verify(argc, argv);
+        }
+        if (argc >= 4 && argc <= 6 && !strcmp(argv[1], "serve"))
+        {
+            return serve(argc, argv);
+        }
+
+        if (argc != 3)
+        {
+            throw std::invalid_argument("Usage:\n \
+            To run a ROM for a number of frames: ./ness-headless <PATH_TO_ROM> <FRAMES>\n \
+            To replay a TAS: ./ness-headless <PATH_TO_ROM> <PATH_TO_TAS_SCRIPT>\n \
+            To log or check per-frame hashes of a TAS: ./ness-headless verify <PATH_TO_ROM> <PATH_TO_TAS_SCRIPT> <LOG> [REFERENCE_LOG]\n \
+            To let another process drive it: ./ness-headless serve <PATH_TO_ROM> <SHM_NAME> [FRAMES_PER_STEP] [indexed]\n");
+        }
+
+        char *end;
+        const uint64_t frames = std::strtoull(argv[2], &end, 10);
+        const bool tas = *end != '\0';
+        NesSystem nes(tas ? NesSystem::PLAY_TAS : NesSystem::PLAY, tas ? argv[2] : "");
+
+        nes.insertCartridge(argv[1]);
+
+        const auto start = std::chrono::steady_clock::now();
+        while (tas ? nes.loadGameplayInput() : nes.getFrameCount() < frames)
+            nes.runFrame();
+        const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+        std::cout << nes.getFrameCount() << " frames in " << seconds.count() << "s ("
+                  << nes.getFrameCount() / seconds.count() << " fps)" << std::endl;
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cerr << "Invalid Execution Commands - " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,21 +1,18 @@
+#include <cstring>
 #include <memory>
 #include <string>
 #include <iostream>
 #include <stdexcept>
 #include <NesSystem.hpp>
+#include <SdlFrontend.hpp>
 
 static std::shared_ptr<NesSystem> nes;
 
-void newSamples(const blip_sample_t *samples, size_t count)
-{
-    nes->newSamples(samples, count);
-}
-
 int main(int argc, char *argv[])
 {
     try
     {
-        if (!strcmp(argv[1], "play") && argc == 3)
+        if (!strcmp(argv[1], "play") && argc >= 3 && argc <= 5)
         {
             nes.reset(new NesSystem(NesSystem::PLAY));
         }
@@ -30,14 +27,25 @@ int main(int argc, char *argv[])
         else
         {
             throw std::invalid_argument("Usage:\n \
-            To play a ROM: ./ness play <PATH_TO_ROM>\n \
+            To play a ROM: ./ness play <PATH_TO_ROM> [RUN_AHEAD_FRAMES] [threaded]\n \
             To record a TAS: ./ness maketas <PATH_TO_ROM> <DESTINATION_PATH_FOR_TAS_SCRIPT>\n \
             To replay a TAS: ./ness playtas <PATH_TO_ROM> <PATH_TO_TAS_SCRIPT>\n");
         }
 
         nes->insertCartridge(argv[2]);
+        if (nes->getState() == NesSystem::PLAY)
+        {
+            nes->enableRewind(REWIND_CAPACITY);
+            if (argc > 3)
+                nes->enableRunAhead(std::stoul(argv[3]), argc > 4 && !strcmp(argv[4], "threaded"));
+        }
+        else if (nes->getState() == NesSystem::RECORD_TAS)
+        {
+            nes->enableGreenzone(GREENZONE_BUDGET);
+        }
 
-        while (nes->run())
+        SdlFrontend frontend(*nes);
+        while (frontend.run())
             ;
     }
     catch (const std::invalid_argument &e)
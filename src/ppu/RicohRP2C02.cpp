@@ -1,9 +1,12 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
 #include <RicohRP2C02.hpp>
 
 #define COLOR(r, g, b) static_cast<uint32_t>(0xFF000000 | ((r) << 0x10) | ((g) << 0x8) | (b))
 
-RicohRP2C02::RicohRP2C02()
-    : palettes {
+RicohRP2C02::RicohRP2C02(PpuState &state)
+    : state{state}, palettes {
         COLOR(84, 84, 84),
         COLOR(0, 30, 116),
         COLOR(8, 16, 144),
@@ -72,7 +75,10 @@ RicohRP2C02::RicohRP2C02()
         COLOR(0, 0, 0),
         COLOR(0, 0, 0)
     },
-    sprScreen{std::vector<uint32_t>(240 * 256, 0x00)} {}
+    sprScreen{std::vector<uint32_t>(240 * 256, 0x00)}, indexScreen(240 * 256, 0x00)
+{
+    updateColourTable();
+}
 
 RicohRP2C02::~RicohRP2C02()
 {
@@ -83,9 +89,45 @@ uint32_t *RicohRP2C02::getFrameBuffData()
     return sprScreen.data();
 }
 
+const uint8_t *RicohRP2C02::getIndexBuffData() const
+{
+    return indexScreen.data();
+}
+
+const uint32_t *RicohRP2C02::getPalette() const
+{
+    return palettes.data();
+}
+
 uint32_t RicohRP2C02::GetColourFromPaletteRam(uint8_t palette, uint8_t pixel)
 {
-    return palettes[localRead(0x3F00 + (palette << 2) + pixel) & 0x3F];
+    return colourTable[(palette << 2) | pixel];
+}
+
+void RicohRP2C02::updateColour(uint8_t entry)
+{
+    indexTable[entry] = tblPalette[entry] & (mask.grayscale ? 0x30 : 0x3F);
+    colourTable[entry] = palettes[indexTable[entry]];
+    // Backdrop entries are shared with the sprite palettes
+    if ((entry & 0x03) == 0)
+    {
+        indexTable[entry | 0x10] = indexTable[entry];
+        colourTable[entry | 0x10] = colourTable[entry];
+    }
+}
+
+void RicohRP2C02::updateColourTable()
+{
+    for (uint8_t i = 0; i < 0x10; ++i)
+        updateColour(i);
+    for (uint8_t i = 0x11; i < 0x20; ++i)
+    {
+        if (i & 0x03)
+        {
+            indexTable[i] = tblPalette[i] & (mask.grayscale ? 0x30 : 0x3F);
+            colourTable[i] = palettes[indexTable[i]];
+        }
+    }
 }
 
 uint8_t RicohRP2C02::getByte(uint16_t addr, bool rdonly)
@@ -137,13 +179,27 @@ void RicohRP2C02::setByte(uint16_t addr, uint8_t data)
     switch (addr)
     {
     case 0x0000:
+    {
+        const int16_t clockDot = scanlineClockDot;
         control.reg = data;
         tram_addr.nametable_x = control.nametable_x;
         tram_addr.nametable_y = control.nametable_y;
+        updateScanlineClock();
+        if (scanlineClockDot != clockDot)
+            cart->irqTimingChanged();
         break;
+    }
     case 0x0001:
+    {
+        const bool grayscaleChanged = (mask.reg ^ data) & 0x01;
+        const bool rendering = renderingEnabled();
         mask.reg = data;
+        if (grayscaleChanged)
+            updateColourTable();
+        if (scanlineClockDot >= 0 && renderingEnabled() != rendering)
+            cart->irqTimingChanged();
         break;
+    }
     case 0x0003:
         oam_addr = data;
         break;
@@ -191,34 +247,11 @@ uint8_t RicohRP2C02::localRead(uint16_t addr, bool rdonly)
 
     if (addr >= 0x0000 && addr <= 0x1FFF)
     {
-        data = cart->read(addr, 0x2000);
+        data = cart->readChr(addr);
     }
     else if (addr >= 0x2000 && addr <= 0x3EFF)
     {
-        addr &= 0x0FFF;
-
-        if (cart->getMirrorMode() == GamePak::MirrorMode::VERTICAL)
-        {
-            if (addr >= 0x0000 && addr <= 0x03FF)
-                data = tblName[0][addr & 0x03FF];
-            if (addr >= 0x0400 && addr <= 0x07FF)
-                data = tblName[1][addr & 0x03FF];
-            if (addr >= 0x0800 && addr <= 0x0BFF)
-                data = tblName[0][addr & 0x03FF];
-            if (addr >= 0x0C00 && addr <= 0x0FFF)
-                data = tblName[1][addr & 0x03FF];
-        }
-        else if (cart->getMirrorMode() == GamePak::MirrorMode::HORIZONTAL)
-        {
-            if (addr >= 0x0000 && addr <= 0x03FF)
-                data = tblName[0][addr & 0x03FF];
-            if (addr >= 0x0400 && addr <= 0x07FF)
-                data = tblName[0][addr & 0x03FF];
-            if (addr >= 0x0800 && addr <= 0x0BFF)
-                data = tblName[1][addr & 0x03FF];
-            if (addr >= 0x0C00 && addr <= 0x0FFF)
-                data = tblName[1][addr & 0x03FF];
-        }
+        data = nametable[(addr >> 10) & 0x03][addr & 0x03FF];
     }
     else if (addr >= 0x3F00 && addr <= 0x3FFF)
     {
@@ -243,33 +276,11 @@ void RicohRP2C02::localWrite(uint16_t addr, uint8_t data)
 
     if (addr >= 0x0000 && addr <= 0x1FFF)
     {
-        cart->write(addr, 0x1FFF, data);
+        cart->writeChr(addr, data);
     }
     else if (addr >= 0x2000 && addr <= 0x3EFF)
     {
-        addr &= 0x0FFF;
-        if (cart->getMirrorMode() == GamePak::MirrorMode::VERTICAL)
-        {
-            if (addr >= 0x0000 && addr <= 0x03FF)
-                tblName[0][addr & 0x03FF] = data;
-            if (addr >= 0x0400 && addr <= 0x07FF)
-                tblName[1][addr & 0x03FF] = data;
-            if (addr >= 0x0800 && addr <= 0x0BFF)
-                tblName[0][addr & 0x03FF] = data;
-            if (addr >= 0x0C00 && addr <= 0x0FFF)
-                tblName[1][addr & 0x03FF] = data;
-        }
-        else if (cart->getMirrorMode() == GamePak::MirrorMode::HORIZONTAL)
-        {
-            if (addr >= 0x0000 && addr <= 0x03FF)
-                tblName[0][addr & 0x03FF] = data;
-            if (addr >= 0x0400 && addr <= 0x07FF)
-                tblName[0][addr & 0x03FF] = data;
-            if (addr >= 0x0800 && addr <= 0x0BFF)
-                tblName[1][addr & 0x03FF] = data;
-            if (addr >= 0x0C00 && addr <= 0x0FFF)
-                tblName[1][addr & 0x03FF] = data;
-        }
+        nametable[(addr >> 10) & 0x03][addr & 0x03FF] = data;
     }
     else if (addr >= 0x3F00 && addr <= 0x3FFF)
     {
@@ -283,6 +294,7 @@ void RicohRP2C02::localWrite(uint16_t addr, uint8_t data)
         if (addr == 0x001C)
             addr = 0x000C;
         tblPalette[addr] = data;
+        updateColour(addr);
     }
 }
 
@@ -293,6 +305,8 @@ void RicohRP2C02::reset()
     ppu_data_buffer = 0x00;
     scanline = 0;
     cycle = 0;
+    clock = 0;
+    pending = 0;
     bg_next_tile_id = 0x00;
     bg_next_tile_attrib = 0x00;
     bg_next_tile_lsb = 0x00;
@@ -303,14 +317,106 @@ void RicohRP2C02::reset()
     bg_shifter_attrib_hi = 0x0000;
     status.reg = 0x00;
     mask.reg = 0x00;
+    updateColourTable();
     control.reg = 0x00;
     vram_addr.reg = 0x0000;
     tram_addr.reg = 0x0000;
 }
 
+void RicohRP2C02::stateLoaded()
+{
+    updateColourTable();
+    updateNametablePages();
+    updateScanlineClock();
+}
+
+// Number of calls to run() up to and including the one that renders the given dot
+uint32_t RicohRP2C02::dotsUntil(int16_t targetScanline, int16_t targetCycle) const
+{
+    constexpr int32_t frameLength = SCANLINE_DOTS * 262;
+    // Dot 0 of scanline 0 is rendered by the same call as dot 1
+    constexpr int32_t skippedDot = SCANLINE_DOTS;
+
+    const int32_t from = (scanline + 1) * SCANLINE_DOTS + cycle;
+    const int32_t to = (targetScanline + 1) * SCANLINE_DOTS + targetCycle;
+    const int32_t distance = (to - from + frameLength) % frameLength;
+    const bool skips = (skippedDot - from + frameLength) % frameLength < distance;
+
+    return distance + 1 - skips;
+}
+
 void RicohRP2C02::addCartridge(const std::shared_ptr<AddressableDevice> cartridge)
 {
-    assert(this->cart = dynamic_cast<GamePak *>(cartridge.get()));
+    cart = dynamic_cast<GamePak *>(cartridge.get());
+    assert(cart);
+    cart->ppu = this;
+    updateNametablePages();
+    updateScanlineClock();
+}
+
+/*
+ * A12 rises once per rendered line when the background and sprites use
+ * different pattern tables: at the first sprite fetch if sprites use
+ * $1000, or at the next line's first background fetch if the background
+ * does. Other layouts are taken to be the former.
+ */
+void RicohRP2C02::updateScanlineClock()
+{
+    if (!cart->scanlineCounter)
+        scanlineClockDot = -1;
+    else if (!control.sprite_size && !control.pattern_sprite)
+        scanlineClockDot = control.pattern_background ? 324 : -1;
+    else
+        scanlineClockDot = 260;
+}
+
+// Calls to run() until A12 clocks the cartridge's scanline counter for the clocks-th time, or 0 if it never will as things stand
+uint32_t RicohRP2C02::dotsUntilScanlineClock(uint32_t clocks) const
+{
+    if (scanlineClockDot < 0 || !renderingEnabled() || clocks == 0)
+        return 0;
+
+    // Rendered lines -1 to 239 numbered from 0, starting with the next edge
+    int32_t line = scanline + 1;
+    if (line > 240)
+        line = 0;
+    else if (cycle > scanlineClockDot && ++line > 240)
+        line = 0;
+
+    // Edges more than a frame away are reached in steps, the last rendered line being as far as a single one goes
+    const int32_t target = std::min<int32_t>(line + clocks - 1, 240);
+
+    return dotsUntil(target - 1, scanlineClockDot);
+}
+
+uint64_t RicohRP2C02::getClock() const
+{
+    return clock;
+}
+
+void RicohRP2C02::updateNametablePages()
+{
+    switch (cart->getMirrorMode())
+    {
+    case GamePak::MirrorMode::VERTICAL:
+        nametable[0] = nametable[2] = tblName[0];
+        nametable[1] = nametable[3] = tblName[1];
+        break;
+    case GamePak::MirrorMode::HORIZONTAL:
+        nametable[0] = nametable[1] = tblName[0];
+        nametable[2] = nametable[3] = tblName[1];
+        break;
+    case GamePak::MirrorMode::SINGLE_SCREEN_LOW:
+        nametable[0] = nametable[1] = nametable[2] = nametable[3] = tblName[0];
+        break;
+    case GamePak::MirrorMode::SINGLE_SCREEN_HIGH:
+        nametable[0] = nametable[1] = nametable[2] = nametable[3] = tblName[1];
+        break;
+    case GamePak::MirrorMode::FOUR_SCREEN:
+        for (uint8_t i = 0; i < 4; ++i)
+            nametable[i] = tblName[i];
+        break;
+    }
 }
 
 void RicohRP2C02::scrollX()
@@ -407,14 +513,16 @@ void RicohRP2C02::updateShifters()
             }
             else
             {
-                sprite_shifter_pattern_lo[i] <<= 1;
-                sprite_shifter_pattern_hi[i] <<= 1;
+                sprite_shifter_pixels[i] >>= 8;
             }
         }
     }
 }
 void RicohRP2C02::run()
 {
+    if (cycle == scanlineClockDot && scanline < 240)
+        clockScanlineCounter();
+
     if (scanline >= -1 && scanline < 240)
     {
         if (scanline == 0 && cycle == 0)
@@ -429,8 +537,7 @@ void RicohRP2C02::run()
 
             for (int i = 0; i < 8; ++i)
             {
-                sprite_shifter_pattern_lo[i] = 0x0;
-                sprite_shifter_pattern_hi[i] = 0x0;
+                sprite_shifter_pixels[i] = 0x0;
             }
         }
 
@@ -486,14 +593,13 @@ void RicohRP2C02::run()
 
         if (cycle == 257 && scanline >= 0)
         {
-            std::memset(spriteScanline, 0xFF, 8 * sizeof(sObjectAttributeEntry));
+            std::memset(spriteScanline, 0xFF, sizeof(spriteScanline));
 
             sprite_count = 0;
 
             for (uint8_t i = 0; i < 8; ++i)
             {
-                sprite_shifter_pattern_lo[i] = 0;
-                sprite_shifter_pattern_hi[i] = 0;
+                sprite_shifter_pixels[i] = 0;
             }
 
             uint8_t nOAMEntry = 0;
@@ -513,7 +619,7 @@ void RicohRP2C02::run()
                             bSpriteZeroHitPossible = true;
                         }
 
-                        memcpy(&spriteScanline[sprite_count], &OAM[nOAMEntry], sizeof(sObjectAttributeEntry));
+                        memcpy(&spriteScanline[sprite_count], &OAM[nOAMEntry], sizeof(PpuState::sObjectAttributeEntry));
                         sprite_count++;
                     }
                 }
@@ -529,7 +635,6 @@ void RicohRP2C02::run()
             for (uint8_t i = 0; i < sprite_count; i++)
             {
 
-                uint8_t sprite_pattern_bits_lo, sprite_pattern_bits_hi;
                 uint16_t sprite_pattern_addr_lo, sprite_pattern_addr_hi;
 
                 if (!control.sprite_size)
@@ -565,36 +670,31 @@ void RicohRP2C02::run()
                         if (scanline - spriteScanline[i].y < 8)
                         {
                             sprite_pattern_addr_lo =
-                                ((spriteScanline[i].id & 0x01) << 12) | (((spriteScanline[i].id & 0xFE) + 1) << 4) | (7 - (scanline - spriteScanline[i].y) & 0x07);
+                                ((spriteScanline[i].id & 0x01) << 12) | (((spriteScanline[i].id & 0xFE) + 1) << 4) | ((7 - (scanline - spriteScanline[i].y)) & 0x07);
                         }
                         else
                         {
                             sprite_pattern_addr_lo =
-                                ((spriteScanline[i].id & 0x01) << 12) | ((spriteScanline[i].id & 0xFE) << 4) | (7 - (scanline - spriteScanline[i].y) & 0x07);
+                                ((spriteScanline[i].id & 0x01) << 12) | ((spriteScanline[i].id & 0xFE) << 4) | ((7 - (scanline - spriteScanline[i].y)) & 0x07);
                         }
                     }
                 }
 
-                sprite_pattern_addr_hi = sprite_pattern_addr_lo + 8;
+                const bool flip = spriteScanline[i].attribute & 0x40;
 
-                sprite_pattern_bits_lo = localRead(sprite_pattern_addr_lo);
-                sprite_pattern_bits_hi = localRead(sprite_pattern_addr_hi);
-
-                if (spriteScanline[i].attribute & 0x40)
+                // Rows that wrapped out of the pattern tables come from wherever the address lands
+                if ((sprite_pattern_addr_lo & 0x3FFF) < 0x2000 && !(sprite_pattern_addr_lo & 0x8))
                 {
-                    auto flipbyte = [](uint8_t b) {
-                        b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
-                        b = (b & 0xCC) >> 2 | (b & 0x33) << 2;
-                        b = (b & 0xAA) >> 1 | (b & 0x55) << 1;
-                        return b;
-                    };
-
-                    sprite_pattern_bits_lo = flipbyte(sprite_pattern_bits_lo);
-                    sprite_pattern_bits_hi = flipbyte(sprite_pattern_bits_hi);
+                    sprite_shifter_pixels[i] = cart->getChrRow(sprite_pattern_addr_lo & 0x3FFF)[flip];
                 }
+                else
+                {
+                    sprite_pattern_addr_hi = sprite_pattern_addr_lo + 8;
+                    sprite_shifter_pixels[i] = ChrCache::decode(localRead(sprite_pattern_addr_lo), localRead(sprite_pattern_addr_hi));
 
-                sprite_shifter_pattern_lo[i] = sprite_pattern_bits_lo;
-                sprite_shifter_pattern_hi[i] = sprite_pattern_bits_hi;
+                    if (flip)
+                        sprite_shifter_pixels[i] = __builtin_bswap64(sprite_shifter_pixels[i]);
+                }
             }
         }
     }
@@ -639,9 +739,7 @@ void RicohRP2C02::run()
         {
             if (spriteScanline[i].x == 0)
             {
-                uint8_t fg_pixel_lo = (sprite_shifter_pattern_lo[i] & 0x80) > 0;
-                uint8_t fg_pixel_hi = (sprite_shifter_pattern_hi[i] & 0x80) > 0;
-                fg_pixel = (fg_pixel_hi << 1) | fg_pixel_lo;
+                fg_pixel = sprite_shifter_pixels[i] & 0x03;
 
                 fg_palette = (spriteScanline[i].attribute & 0x03) + 0x04;
                 fg_priority = (spriteScanline[i].attribute & 0x20) == 0;
@@ -712,12 +810,16 @@ void RicohRP2C02::run()
         }
     }
 
-    if (scanline < 240 and cycle > 0 and cycle <= 256)
+    if (scanline >= 0 and scanline < 240 and cycle > 0 and cycle <= 256)
     {
-        sprScreen[cycle - 1 + scanline * 256] = GetColourFromPaletteRam(palette, pixel);
+        if (indexedOutput)
+            indexScreen[cycle - 1 + scanline * 256] = indexTable[(palette << 2) | pixel];
+        else
+            sprScreen[cycle - 1 + scanline * 256] = GetColourFromPaletteRam(palette, pixel);
     }
 
     ++cycle;
+    ++clock;
 
     if (cycle >= 341)
     {
@@ -728,4 +830,173 @@ void RicohRP2C02::run()
             scanline = -1;
         }
     }
-}
\ No newline at end of file
+}
+void RicohRP2C02::deferUntil(uint64_t dot)
+{
+    pending = dot;
+}
+
+void RicohRP2C02::setScanlineRenderer(bool enabled)
+{
+    scanlineRenderer = enabled;
+}
+
+void RicohRP2C02::setIndexedOutput(bool enabled)
+{
+    indexedOutput = enabled;
+}
+
+/*
+ * Runs the dots the rest of the system has gotten ahead by. Nothing can
+ * touch the PPU while it is behind, so any scanline that fits entirely
+ * in the gap is known to have constant registers and is drawn in one go.
+ * A line interrupted by a register access is finished a dot at a time.
+ */
+void RicohRP2C02::catchUp()
+{
+    while (clock < pending)
+    {
+        if (scanlineRenderer && cycle == 0)
+        {
+            if (scanline >= 0 && scanline < 240 && pending - clock >= SCANLINE_DOTS - (scanline == 0))
+            {
+                renderScanline();
+                continue;
+            }
+            else if (scanline >= 240 && pending - clock >= SCANLINE_DOTS)
+            {
+                idleScanline();
+                continue;
+            }
+        }
+
+        run();
+    }
+}
+
+// Same result as calling run() for every dot of a visible scanline
+void RicohRP2C02::renderScanline()
+{
+    uint8_t bgLine[33 * 8] = {};
+    uint8_t fgLine[256] = {};
+
+    // Dot 0 only composites, and nothing it computes outlives the dot
+    clock += scanline != 0;
+
+    /*
+     * Background as palette << 2 | pixel, starting fine_x pixels to the left.
+     * The first two tiles are already in the shifters; the rest are fetched
+     * the way the dot renderer would, one coarse X step apart. The shifters
+     * and next-tile latches are left alone: they are overwritten by the
+     * prefetch for the next line before anything reads them.
+     */
+    if (mask.render_background)
+    {
+        uint64_t pixels[2];
+
+        pixels[0] = ChrCache::decode(bg_shifter_pattern_lo >> 8, bg_shifter_pattern_hi >> 8) |
+                    (ChrCache::decode(bg_shifter_attrib_lo >> 8, bg_shifter_attrib_hi >> 8) << 2);
+        pixels[1] = ChrCache::decode(bg_shifter_pattern_lo, bg_shifter_pattern_hi) |
+                    (ChrCache::decode(bg_shifter_attrib_lo, bg_shifter_attrib_hi) << 2);
+        std::memcpy(bgLine, pixels, sizeof(pixels));
+
+        uint8_t id = bg_next_tile_id;
+
+        for (uint8_t tile = 2; tile < 33; ++tile)
+        {
+            if (tile > 2)
+                id = nametable[(vram_addr.reg >> 10) & 0x03][vram_addr.reg & 0x03FF];
+
+            uint8_t attrib = nametable[(vram_addr.reg >> 10) & 0x03][0x03C0 | ((vram_addr.coarse_y >> 2) << 3) | (vram_addr.coarse_x >> 2)];
+
+            if (vram_addr.coarse_y & 0x02)
+                attrib >>= 4;
+            if (vram_addr.coarse_x & 0x02)
+                attrib >>= 2;
+            attrib &= 0x03;
+
+            pixels[0] = cart->getChrRow((control.pattern_background << 12) + ((uint16_t)id << 4) + vram_addr.fine_y)[0] |
+                        (attrib * 0x0404040404040404ull);
+            std::memcpy(&bgLine[tile << 3], pixels, sizeof(pixels[0]));
+
+            scrollX();
+        }
+    }
+    else
+    {
+        for (uint8_t tile = 2; tile < 33; ++tile)
+            scrollX();
+    }
+    scrollX();
+    scrollY();
+
+    // Lower sprite indices win, so draw them last. Bits 0-1 pixel, 2-4 palette, 5 priority, 6 sprite zero
+    if (mask.render_sprites)
+    {
+        for (int i = sprite_count - 1; i >= 0; --i)
+        {
+            const uint8_t attrib = (((spriteScanline[i].attribute & 0x03) + 0x04) << 2) |
+                                   (((spriteScanline[i].attribute & 0x20) == 0) << 5) | ((i == 0) << 6);
+
+            for (uint8_t b = 0; b < 8 && spriteScanline[i].x + b < 256; ++b)
+            {
+                const uint8_t fg_pixel = (sprite_shifter_pixels[i] >> (b << 3)) & 0x03;
+                if (fg_pixel != 0)
+                    fgLine[spriteScanline[i].x + b] = attrib | fg_pixel;
+            }
+        }
+    }
+
+    const bool spriteZeroHitPossible = bSpriteZeroHitPossible && mask.render_background && mask.render_sprites;
+    const uint8_t *bgPixels = &bgLine[fine_x];
+    uint32_t *line = &sprScreen[scanline * 256];
+    uint8_t *indexLine = &indexScreen[scanline * 256];
+
+    for (uint16_t x = 0; x < 256; ++x)
+    {
+        const uint8_t bg = bgPixels[x];
+        const uint8_t fg = fgLine[x];
+        uint8_t colour = bg & 0x03 ? bg : 0x00;
+
+        if (fg & 0x03)
+        {
+            if (!(bg & 0x03) || (fg & 0x20))
+                colour = fg & 0x1F;
+
+            if (bg & 0x03 && fg & 0x40 && spriteZeroHitPossible && x >= 8)
+                status.sprite_zero_hit = 1;
+        }
+
+        if (indexedOutput)
+            indexLine[x] = indexTable[colour];
+        else
+            line[x] = colourTable[colour];
+    }
+
+    clock += 256;
+    cycle = 257;
+
+    // Sprite evaluation and the next line's prefetch, then dots 258-320 have no effect beyond A12
+    run();
+    if (scanlineClockDot > 257 && scanlineClockDot <= 320)
+        clockScanlineCounter();
+    clock += 320 - 257;
+    cycle = 321;
+    while (cycle != 0)
+        run();
+}
+
+/*
+ * Nothing moves between the visible area and the pre-render line, so
+ * every dot composites the same way as dot 9, the first one that can
+ * set the sprite zero hit flag.
+ */
+void RicohRP2C02::idleScanline()
+{
+    while (cycle <= 9)
+        run();
+
+    clock += 339 - 9;
+    cycle = 340;
+    run();
+}
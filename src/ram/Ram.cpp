@@ -1,6 +1,6 @@
 #include <Ram.hpp>
 
-Ram::Ram(const uint16_t size) : contents{std::vector<uint8_t>(size, 0x00)} {}
+Ram::Ram(uint8_t *contents) : contents{contents} {}
 
 inline void Ram::setByte(uint16_t addr, uint8_t data)
 {
@@ -10,4 +10,15 @@ inline void Ram::setByte(uint16_t addr, uint8_t data)
 inline uint8_t Ram::getByte(uint16_t addr, bool readOnly)
 {
     return contents[addr];
-}
\ No newline at end of file
+}
+
+uint8_t *Ram::getPage(uint16_t addr, uint16_t mirror, bool write)
+{
+    (void)write;
+
+    // A page must not straddle a mirror boundary
+    if (mirror < 0x0100)
+        return nullptr;
+
+    return &contents[mirrorAddress(addr, mirror)];
+}
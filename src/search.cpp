@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <BeamSearch.hpp>
+#include <ForkExplorer.hpp>
+#include <NesSystem.hpp>
+#include <TasMovie.hpp>
+
+// Enough branches to fill a big machine without the suffix list outgrowing its memory
+#define BRANCH_MAX_COUNT (1 << 22)
+
+// A count argument; std::stoul throws on junk, and anything past 32 bits is out of range here too
+static uint32_t parseCount(const char *arg)
+{
+    const unsigned long value = std::stoul(arg);
+
+    if (value > UINT32_MAX)
+        throw std::out_of_range(std::string{arg} + " is too large");
+    return value;
+}
+
+/*
+ * Tries every sequence of depth held actions from the end of the prefix
+ * movie, each in a forked copy of this process, and writes the best one.
+ */
+static int branch(int argc, char *argv[])
+{
+    const RamExpression fitness(argv[4]);
+    const uint32_t depth = argc > 5 ? parseCount(argv[5]) : 4;
+    const uint32_t hold = argc > 6 ? std::max(1u, parseCount(argv[6])) : 4;
+    const std::vector<uint8_t> &actions = BeamSearch::defaultActions();
+
+    size_t count = 1;
+    for (uint32_t i = 0; i < depth; ++i)
+    {
+        count *= actions.size();
+        if (count > BRANCH_MAX_COUNT)
+            throw std::invalid_argument("Too many branches; lower the depth");
+    }
+
+    NesSystem nes(NesSystem::PLAY);
+    std::vector<uint8_t> startState;
+    std::vector<uint8_t> prefix;
+
+    nes.insertCartridge(argv[2]);
+    if (argc > 7)
+        playPrefixMovie(nes, argv[7], startState, prefix);
+
+    std::vector<std::vector<uint8_t>> suffixes(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (size_t code = i, step = 0; step < depth; ++step, code /= actions.size())
+            suffixes[i].insert(suffixes[i].end(), hold, actions[code % actions.size()]);
+    }
+
+    ForkExplorer explorer(nes, fitness);
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<BranchResult> results = explorer.explore(suffixes);
+    const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+    size_t best = count;
+    size_t failed = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!results[i].completed)
+            ++failed;
+        else if (best == count || results[i].fitness > results[best].fitness)
+            best = i;
+    }
+
+    std::cout << count << " branches of " << depth * hold << " frames in " << seconds.count() << "s ("
+              << count / seconds.count() << " branches/s), " << failed << " failed" << std::endl;
+    if (best == count)
+        return 1;
+
+    TasWriter movie(nes.getRomCrc());
+    if (!startState.empty())
+        movie.setStartState(startState);
+    for (uint8_t input : prefix)
+        movie.push(&input);
+    for (uint8_t input : suffixes[best])
+        movie.push(&input);
+
+    if (!movie.save(argv[3]))
+    {
+        std::cerr << "Could not write the TAS movie to " << argv[3] << std::endl;
+        return 1;
+    }
+
+    std::cout << "Best fitness " << results[best].fitness << ", written to " << argv[3] << std::endl;
+    return 0;
+}
+
+/*
+ * Searches for input that maximises a RAM expression and writes the best
+ * run found as a TAS movie, optionally continuing from an existing one.
+ */
+int main(int argc, char *argv[])
+{
+    try
+    {
+        if (argc >= 5 && argc <= 8 && !strcmp(argv[1], "branch"))
+            return branch(argc, argv);
+
+        if (argc < 4 || argc > 8)
+        {
+            throw std::invalid_argument("Usage:\n \
+            ./ness-search <PATH_TO_ROM> <OUTPUT_TAS> <FITNESS> [FRAMES] [BEAM_WIDTH] [HOLD_FRAMES] [PREFIX_TAS]\n \
+            ./ness-search branch <PATH_TO_ROM> <OUTPUT_TAS> <FITNESS> [DEPTH] [HOLD_FRAMES] [PREFIX_TAS]\n \
+            FITNESS is an expression over RAM bytes, e.g. \"$6D * 256 + $86\" for Mario's X position\n");
+        }
+
+        SearchConfig config;
+        config.romName = argv[1];
+        config.fitness = argv[3];
+        if (argc > 4)
+            config.frames = parseCount(argv[4]);
+        if (argc > 5)
+            config.beamWidth = parseCount(argv[5]);
+        if (argc > 6)
+            config.hold = std::max(1u, parseCount(argv[6]));
+        if (argc > 7)
+            config.prefixMovie = argv[7];
+
+        BeamSearch search(config);
+        const auto start = std::chrono::steady_clock::now();
+
+        while (search.step())
+        {
+            std::cout << "frame " << search.getFrame() << ": best " << search.getBestFitness() << ", "
+                      << search.getTranspositions() << " transpositions pruned" << std::endl;
+        }
+
+        const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+        if (!search.saveMovie(argv[2]))
+        {
+            std::cerr << "Could not write the TAS movie to " << argv[2] << std::endl;
+            return 1;
+        }
+
+        std::cout << "Best fitness " << search.getBestFitness() << " after " << seconds.count() << "s, written to "
+                  << argv[2] << std::endl;
+    }
+    // Bad numbers surface as std::invalid_argument or std::out_of_range from std::stoul
+    catch (const std::logic_error &e)
+    {
+        std::cerr << "Invalid Execution Commands - " << e.what() << std::endl;
+        return 1;
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}